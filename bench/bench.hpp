@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_BENCH_HPP
+#define SELENA_BENCH_HPP
+
+// Tiny, self-contained benchmark harness. No dependencies apart from the standard library.
+// Each benchmark is a function taking an iteration count; it's timed as a batch, and the batch
+// size is calibrated so that one sample takes roughly "min_sample_ns".
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define SELENA_BENCH_HAS_TSC 1
+#else
+  #define SELENA_BENCH_HAS_TSC 0
+#endif
+
+namespace selena::bench {
+// Keeps the compiler from optimizing away a computed value.
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink{ nullptr };
+  sink = &value;
+#endif
+}
+
+// Keeps the compiler from assuming memory hasn't changed between iterations.
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : : "memory");
+#endif
+}
+
+inline uint64_t now_ns() {
+  timespec ts{};
+#ifdef CLOCK_MONOTONIC_RAW
+  clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+inline uint64_t now_cycles() {
+#if SELENA_BENCH_HAS_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Runs fn(thread_index) on "threads" threads at once, for multithreaded benchmarks. Threads are
+// started before any of them runs "fn", so creating them isn't part of the contended part.
+template<typename F>
+inline void run_threads(const size_t threads, F&& fn) {
+  std::atomic<size_t> ready{ 0 };
+  std::vector<std::thread> pool{};
+  pool.reserve(threads);
+  for (size_t t{ 0 }; t < threads; ++t) {
+    pool.emplace_back([&, t] {
+      ready.fetch_add(1, std::memory_order_acq_rel);
+      while (ready.load(std::memory_order_acquire) < threads) std::this_thread::yield();
+      fn(t);
+    });
+  }
+  for (std::thread& thread : pool) thread.join();
+}
+
+struct config {
+  uint64_t warmup_ns{ 50'000'000 };
+  uint64_t min_sample_ns{ 2'000'000 };
+  size_t samples{ 30 };
+  std::string filter{};
+};
+
+struct result {
+  std::string name{};
+  size_t iterations_per_sample{ 0 };
+  size_t samples_kept{ 0 };
+  size_t outliers{ 0 };
+  // Per-operation latency, in ns
+  double mean{ 0 }, min{ 0 }, p50{ 0 }, p90{ 0 }, p99{ 0 }, max{ 0 }, stddev{ 0 };
+  double cycles_per_op{ 0 }; // TSC (reference) cycles. 0 when the TSC isn't available
+  double ops_per_sec{ 0 };
+  double gb_per_sec{ 0 };    // Only for benchmarks registered with a byte count
+};
+
+struct benchmark {
+  std::string name{};
+  std::function<void(size_t)> fn{};
+  size_t bytes_per_op{ 0 }; // Set for throughput benchmarks, reported as GB/s
+};
+
+inline std::vector<benchmark>& registry() {
+  static std::vector<benchmark> benchmarks{};
+  return benchmarks;
+}
+
+struct registrar {
+  registrar(const char* const name, std::function<void(size_t)> fn) {
+    registry().push_back({ name, std::move(fn) });
+  }
+  registrar(const char* const name, const size_t bytes_per_op, std::function<void(size_t)> fn) {
+    registry().push_back({ name, std::move(fn), bytes_per_op });
+  }
+};
+
+inline double percentile(const std::vector<double>& sorted, const double p) {
+  if (sorted.empty()) return 0;
+  const double rank{ p * static_cast<double>(sorted.size() - 1) };
+  const size_t lo{ static_cast<size_t>(rank) };
+  const size_t hi{ std::min(lo + 1, sorted.size() - 1) };
+  return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - static_cast<double>(lo));
+}
+
+inline result run(const benchmark& b, const config& cfg) {
+  // Calibration: double the batch until a single batch is long enough to be timed reliably
+  const uint64_t warmup_end{ now_ns() + cfg.warmup_ns };
+  size_t iterations{ 1 };
+  for (;;) {
+    const uint64_t start{ now_ns() };
+    b.fn(iterations);
+    if (now_ns() - start >= cfg.min_sample_ns || iterations >= (size_t{ 1 } << 40)) break;
+    iterations *= 2;
+  }
+  // Warm-up: caches, branch predictors, lazily initialized thread_locals, CPU frequency
+  while (now_ns() < warmup_end) b.fn(iterations);
+
+  std::vector<double> per_op{};
+  std::vector<double> cycles{};
+  per_op.reserve(cfg.samples);
+  cycles.reserve(cfg.samples);
+  for (size_t s{ 0 }; s < cfg.samples; ++s) {
+    const uint64_t c0{ now_cycles() };
+    const uint64_t t0{ now_ns() };
+    b.fn(iterations);
+    const uint64_t t1{ now_ns() };
+    const uint64_t c1{ now_cycles() };
+    per_op.push_back(static_cast<double>(t1 - t0) / static_cast<double>(iterations));
+    cycles.push_back(static_cast<double>(c1 - c0) / static_cast<double>(iterations));
+  }
+
+  // Tukey's fences: anything beyond 1.5 IQR of the quartiles is treated as noise (preemption, etc.)
+  std::vector<double> sorted{ per_op };
+  std::sort(sorted.begin(), sorted.end());
+  const double q1{ percentile(sorted, 0.25) }, q3{ percentile(sorted, 0.75) };
+  const double lo{ q1 - 1.5 * (q3 - q1) }, hi{ q3 + 1.5 * (q3 - q1) };
+
+  std::vector<double> kept{}, kept_cycles{};
+  for (size_t i{ 0 }; i < per_op.size(); ++i) {
+    if (per_op[i] < lo || per_op[i] > hi) continue;
+    kept.push_back(per_op[i]);
+    kept_cycles.push_back(cycles[i]);
+  }
+  std::sort(kept.begin(), kept.end());
+
+  result r{};
+  r.name = b.name;
+  r.iterations_per_sample = iterations;
+  r.samples_kept = kept.size();
+  r.outliers = per_op.size() - kept.size();
+  for (const double v : kept) r.mean += v;
+  r.mean /= static_cast<double>(kept.size());
+  for (const double v : kept) r.stddev += (v - r.mean) * (v - r.mean);
+  r.stddev = kept.size() > 1 ? std::sqrt(r.stddev / static_cast<double>(kept.size() - 1)) : 0;
+  r.min = kept.front();
+  r.max = kept.back();
+  r.p50 = percentile(kept, 0.50);
+  r.p90 = percentile(kept, 0.90);
+  r.p99 = percentile(kept, 0.99);
+  r.ops_per_sec = r.mean > 0 ? 1e9 / r.mean : 0;
+  r.gb_per_sec = r.ops_per_sec * static_cast<double>(b.bytes_per_op) / 1e9;
+  if (SELENA_BENCH_HAS_TSC) {
+    for (const double c : kept_cycles) r.cycles_per_op += c;
+    r.cycles_per_op /= static_cast<double>(kept_cycles.size());
+  }
+  return r;
+}
+
+inline void print_table_header(std::FILE* const out) {
+  std::fprintf(out, "%-44s %12s %12s %12s %12s %10s %14s\n", "benchmark", "p50 ns", "p90 ns", "p99 ns", "mean ns",
+    "cycles", "ops/s");
+}
+
+inline void print_table_row(std::FILE* const out, const result& r) {
+  std::fprintf(out, "%-44s %12.1f %12.1f %12.1f %12.1f %10.1f %14.0f", r.name.c_str(), r.p50, r.p90, r.p99, r.mean,
+    r.cycles_per_op, r.ops_per_sec);
+  if (r.gb_per_sec > 0) std::fprintf(out, " %8.3f GB/s", r.gb_per_sec);
+  std::fputc('\n', out);
+}
+
+inline std::string json_escape(const std::string& s) {
+  std::string ret{};
+  for (const char c : s) {
+    if (c == '"' || c == '\\') ret += '\\';
+    ret += c;
+  }
+  return ret;
+}
+
+inline void write_json(std::FILE* const out, const std::vector<result>& results) {
+  std::fprintf(out, "{\n  \"benchmarks\": [\n");
+  for (size_t i{ 0 }; i < results.size(); ++i) {
+    const result& r{ results[i] };
+    std::fprintf(out,
+      "    {\"name\": \"%s\", \"iterations_per_sample\": %zu, \"samples\": %zu, \"outliers\": %zu, "
+      "\"mean_ns\": %.3f, \"stddev_ns\": %.3f, \"min_ns\": %.3f, \"p50_ns\": %.3f, \"p90_ns\": %.3f, "
+      "\"p99_ns\": %.3f, \"max_ns\": %.3f, \"cycles_per_op\": %.3f, \"ops_per_sec\": %.3f, \"gb_per_sec\": %.3f}%s\n",
+      json_escape(r.name).c_str(), r.iterations_per_sample, r.samples_kept, r.outliers, r.mean, r.stddev, r.min, r.p50,
+      r.p90, r.p99, r.max, r.cycles_per_op, r.ops_per_sec, r.gb_per_sec, i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(out, "  ]\n}\n");
+}
+} // namespace selena::bench
+
+#define SELENA_BENCH_CONCAT_IMPL(a, b) a##b
+#define SELENA_BENCH_CONCAT(a, b) SELENA_BENCH_CONCAT_IMPL(a, b)
+
+// Usage: SELENA_BENCH("group/name", [](size_t n) { for (size_t i{ 0 }; i < n; ++i) ...; });
+#define SELENA_BENCH(name, ...) \
+  static const selena::bench::registrar SELENA_BENCH_CONCAT(_selena_bench_, __LINE__){ name, __VA_ARGS__ }
+
+// Same, for throughput: every iteration processes "bytes" bytes, reported as GB/s
+#define SELENA_BENCH_BYTES(name, bytes, ...) \
+  static const selena::bench::registrar SELENA_BENCH_CONCAT(_selena_bench_, __LINE__){ name, bytes, __VA_ARGS__ }
+
+#endif // SELENA_BENCH_HPP
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// file_reader and mapped_file only exist on POSIX
+#ifndef _WIN32
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <unistd.h>
+
+#include "bench.hpp"
+#include "file_reader.hpp"
+#include "mapped_file.hpp"
+#include "utils.hpp"
+
+namespace {
+// The file is in the page cache after the first pass, so this measures the read path and the
+// validation it overlaps with - not the disk.
+constexpr size_t file_bytes{ size_t{ 32 } << 20 };
+
+// One URL per line, every 16th one invalid, cut at exactly file_bytes. Removed at exit.
+struct url_file {
+  char path[32]{ "/tmp/selena_bench_XXXXXX" };
+
+  url_file() {
+    const int fd{ ::mkstemp(path) };
+    if (fd == -1) std::abort();
+    std::string content{};
+    content.reserve(file_bytes + 128);
+    for (size_t i{ 0 }; content.size() < file_bytes; ++i) {
+      content += "https://www.example.com/some/path/";
+      content += std::to_string(i);
+      content += (i % 16 == 15) ? "?q=$bad\n" : "?q=good\n";
+    }
+    content.resize(file_bytes);
+    if (::write(fd, content.data(), content.size()) != static_cast<ssize_t>(content.size())) std::abort();
+    ::close(fd);
+  }
+  ~url_file() { ::unlink(path); }
+
+  NO_COPY_MOVE(url_file)
+};
+
+// Written on first use, so that filtering these benchmarks out costs nothing
+const char* urls_path() {
+  static const url_file file{};
+  return file.path;
+}
+
+selena::file_reader_options pread_only() {
+  selena::file_reader_options opts{};
+  opts.use_io_uring = false;
+  return opts;
+}
+
+SELENA_BENCH_BYTES("io/read_32mib/ifstream", file_bytes, [](const size_t n) {
+  const std::unique_ptr<char[]> buf{ std::make_unique<char[]>(size_t{ 1 } << 20) };
+  for (size_t i{ 0 }; i < n; ++i) {
+    std::ifstream in{ urls_path(), std::ios::binary };
+    while (in.read(buf.get(), size_t{ 1 } << 20) || in.gcount()) selena::bench::do_not_optimize(buf[0]);
+  }
+});
+
+SELENA_BENCH_BYTES("io/read_32mib/file_reader_pread", file_bytes, [](const size_t n) {
+  selena::file_reader reader{ pread_only() };
+  for (size_t i{ 0 }; i < n; ++i)
+    selena::bench::do_not_optimize(reader.read(urls_path(), [](std::string_view b) { selena::bench::do_not_optimize(b[0]); }));
+});
+
+SELENA_BENCH_BYTES("io/read_32mib/file_reader_io_uring", file_bytes, [](const size_t n) {
+  selena::file_reader reader{};
+  for (size_t i{ 0 }; i < n; ++i)
+    selena::bench::do_not_optimize(reader.read(urls_path(), [](std::string_view b) { selena::bench::do_not_optimize(b[0]); }));
+});
+
+// Splitting into lines reads every byte, as the others do
+SELENA_BENCH_BYTES("io/read_32mib/mapped_file_lines", file_bytes, [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) {
+    const selena::mapped_file file{ urls_path() };
+    size_t count{ 0 };
+    for (const std::string_view line : file.lines()) count += !line.empty();
+    selena::bench::do_not_optimize(count);
+  }
+});
+
+SELENA_BENCH_BYTES("io/is_valid_url_32mib/ifstream_getline", file_bytes, [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) {
+    std::ifstream in{ urls_path() };
+    size_t valid{ 0 };
+    for (std::string line{}; std::getline(in, line);) valid += selena::is_valid_url(line);
+    selena::bench::do_not_optimize(valid);
+  }
+});
+
+SELENA_BENCH_BYTES("io/is_valid_url_32mib/file_reader_pread", file_bytes, [](const size_t n) {
+  selena::file_reader reader{ pread_only() };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::count_valid_urls(reader, urls_path()).valid);
+});
+
+SELENA_BENCH_BYTES("io/is_valid_url_32mib/file_reader_io_uring", file_bytes, [](const size_t n) {
+  selena::file_reader reader{};
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::count_valid_urls(reader, urls_path()).valid);
+});
+
+template<bool Populate>
+void valid_urls_mapped(const size_t n) {
+  selena::mapped_file_options opts{};
+  opts.populate = Populate;
+  for (size_t i{ 0 }; i < n; ++i) {
+    const selena::mapped_file file{ urls_path(), opts };
+    size_t valid{ 0 };
+    for (const std::string_view line : file.lines()) valid += selena::is_valid_url(line);
+    selena::bench::do_not_optimize(valid);
+  }
+}
+
+SELENA_BENCH_BYTES("io/is_valid_url_32mib/mapped_file", file_bytes, valid_urls_mapped<false>);
+SELENA_BENCH_BYTES("io/is_valid_url_32mib/mapped_file_populate", file_bytes, valid_urls_mapped<true>);
+} // namespace
+
+#endif // _WIN32
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <cstdint>
+
+#include "bench.hpp"
+#include "padded.hpp"
+
+namespace {
+// Contended counter: "n" increments split across the threads, so ops/s is the aggregate throughput.
+// Four ways of laying the counter out:
+//   shared   - one atomic everybody hits
+//   adjacent - one atomic per thread, packed next to each other (false sharing)
+//   padded   - one padded<atomic> per thread
+//   per_cpu  - selena::per_cpu, read back with combine()
+using counter = std::atomic<uint64_t>;
+
+size_t all_threads() {
+  const size_t n{ std::thread::hardware_concurrency() };
+  return n ? n : 1;
+}
+
+void shared(const size_t threads, const size_t n) {
+  counter c{ 0 };
+  selena::bench::run_threads(threads, [&](size_t) {
+    for (size_t i{ 0 }; i < n / threads; ++i) c.fetch_add(1, std::memory_order_relaxed);
+  });
+  selena::bench::do_not_optimize(c.load());
+}
+
+void adjacent(const size_t threads, const size_t n) {
+  const std::unique_ptr<counter[]> c{ std::make_unique<counter[]>(threads) };
+  selena::bench::run_threads(threads, [&](const size_t t) {
+    for (size_t i{ 0 }; i < n / threads; ++i) c[t].fetch_add(1, std::memory_order_relaxed);
+  });
+  selena::bench::do_not_optimize(c[0].load());
+}
+
+void padded(const size_t threads, const size_t n) {
+  const std::unique_ptr<selena::padded<counter>[]> c{ std::make_unique<selena::padded<counter>[]>(threads) };
+  selena::bench::run_threads(threads, [&](const size_t t) {
+    for (size_t i{ 0 }; i < n / threads; ++i) c[t]->fetch_add(1, std::memory_order_relaxed);
+  });
+  selena::bench::do_not_optimize(c[0]->load());
+}
+
+void per_cpu(const size_t threads, const size_t n) {
+  selena::per_cpu<counter> c{};
+  selena::bench::run_threads(threads, [&](size_t) {
+    for (size_t i{ 0 }; i < n / threads; ++i) c.local().fetch_add(1, std::memory_order_relaxed);
+  });
+  selena::bench::do_not_optimize(c.combine(uint64_t{ 0 }, [](const uint64_t acc, const counter& v) {
+    return acc + v.load(std::memory_order_relaxed);
+  }));
+}
+
+SELENA_BENCH("padded/counter/shared/x1", [](const size_t n) { shared(1, n); });
+SELENA_BENCH("padded/counter/shared/x4", [](const size_t n) { shared(4, n); });
+SELENA_BENCH("padded/counter/shared/all_threads", [](const size_t n) { shared(all_threads(), n); });
+SELENA_BENCH("padded/counter/adjacent/x4", [](const size_t n) { adjacent(4, n); });
+SELENA_BENCH("padded/counter/adjacent/all_threads", [](const size_t n) { adjacent(all_threads(), n); });
+SELENA_BENCH("padded/counter/padded/x4", [](const size_t n) { padded(4, n); });
+SELENA_BENCH("padded/counter/padded/all_threads", [](const size_t n) { padded(all_threads(), n); });
+SELENA_BENCH("padded/counter/per_cpu/x1", [](const size_t n) { per_cpu(1, n); });
+SELENA_BENCH("padded/counter/per_cpu/x4", [](const size_t n) { per_cpu(4, n); });
+SELENA_BENCH("padded/counter/per_cpu/all_threads", [](const size_t n) { per_cpu(all_threads(), n); });
+} // namespace
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+
+#include "bench.hpp"
+#include "permutation.hpp"
+
+namespace {
+// 2^40 IDs: the Feistel domain is exactly 2^40, so no cycle-walking
+const selena::random_permutation pow2{ uint64_t{ 1 } << 40, 42 };
+// Just past 2^40: the domain is 2^41, so ~2 passes through the network per value
+const selena::random_permutation past_pow2{ (uint64_t{ 1 } << 40) + 1, 42 };
+// 10^6: 20 bits, so 6 rounds of 10 bits halves, and cycle-walking from 2^20 (~1.05 passes)
+const selena::random_permutation million{ 1'000'000, 42 };
+
+SELENA_BENCH("permutation/at/2^40", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(pow2.at(i));
+});
+
+SELENA_BENCH("permutation/at/2^40+1", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(past_pow2.at(i));
+});
+
+SELENA_BENCH("permutation/index_of/2^40", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(pow2.index_of(i));
+});
+
+SELENA_BENCH("permutation/iterate/1e6", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) {
+    uint64_t sum{ 0 };
+    for (const uint64_t id : million) sum += id;
+    selena::bench::do_not_optimize(sum);
+  }
+});
+} // namespace
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+
+#include <cstdint>
+
+#include "bench.hpp"
+#include "pool.hpp"
+
+namespace {
+// Stand-in for a NO_COPY_MOVE class which has to live on the heap
+struct object {
+  explicit object(const uint64_t seed) : value{ seed } {}
+  NO_COPY_MOVE(object)
+  uint64_t value;
+  uint64_t payload[7]{};
+};
+
+// Every thread keeps "window" objects alive and replaces the oldest one on each iteration, so
+// allocations and frees interleave the way they do in a server loop. "n" pairs of acquire/release are
+// split across the threads, so ops/s is the aggregate throughput.
+constexpr size_t window{ 32 };
+
+template<typename Acquire, typename Release>
+void churn(const size_t threads, const size_t n, Acquire acquire, Release release) {
+  const size_t per_thread{ n / threads + 1 };
+  selena::bench::run_threads(threads, [&](const size_t t) {
+    object* live[window]{};
+    for (size_t i{ 0 }; i < per_thread; ++i) {
+      object*& slot{ live[i % window] };
+      release(slot);
+      slot = acquire(t + i);
+      selena::bench::do_not_optimize(slot->value);
+    }
+    for (object* const obj : live) release(obj);
+  });
+}
+
+const auto new_object = [](const uint64_t seed) { return new object{ seed }; };
+const auto delete_object = [](object* const obj) { delete obj; };
+const auto pool_acquire = [](const uint64_t seed) { return selena::object_pool<object>::acquire(seed); };
+const auto pool_release = [](object* const obj) { selena::object_pool<object>::release(obj); };
+
+size_t all_threads() {
+  const size_t n{ std::thread::hardware_concurrency() };
+  return n ? n : 1;
+}
+
+SELENA_BENCH("pool/new_delete/x1", [](const size_t n) { churn(1, n, new_object, delete_object); });
+SELENA_BENCH("pool/object_pool/x1", [](const size_t n) { churn(1, n, pool_acquire, pool_release); });
+
+SELENA_BENCH("pool/new_delete/x4", [](const size_t n) { churn(4, n, new_object, delete_object); });
+SELENA_BENCH("pool/object_pool/x4", [](const size_t n) { churn(4, n, pool_acquire, pool_release); });
+
+SELENA_BENCH("pool/new_delete/all_threads", [](const size_t n) {
+  churn(all_threads(), n, new_object, delete_object);
+});
+SELENA_BENCH("pool/object_pool/all_threads", [](const size_t n) {
+  churn(all_threads(), n, pool_acquire, pool_release);
+});
+} // namespace
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Process launching only exists on POSIX
+#ifndef _WIN32
+
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "process.hpp"
+#include "zygote.hpp"
+
+#ifdef __linux__
+  #include "async_process.hpp"
+  #include "coro.hpp"
+#endif // __linux__
+
+namespace {
+const char* const true_argv[]{ "true", nullptr };
+
+selena::spawn_options suppressed() {
+  selena::spawn_options opts{};
+  opts.suppressed = true;
+  return opts;
+}
+
+// Constructed during static initialization, i.e. before main() - as early as it gets
+selena::zygote& shared_zygote() {
+  static selena::zygote z{};
+  return z;
+}
+[[maybe_unused]] const selena::zygote& zygote_init{ shared_zygote() };
+
+SELENA_BENCH("process/run", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::run(true_argv));
+});
+
+SELENA_BENCH("process/run_shell/direct", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::run_shell("echo hello", suppressed()));
+});
+
+SELENA_BENCH("process/run_shell/via_sh", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::run_shell("echo \"hello\"", suppressed()));
+});
+
+SELENA_BENCH("process/run_measured", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::run_measured(true_argv));
+});
+
+SELENA_BENCH("process/run_all_x8", [](const size_t n) {
+  const std::vector<std::string> commands(8, "true");
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::run_all(commands));
+});
+
+SELENA_BENCH("process/zygote/run", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(shared_zygote().run(true_argv));
+});
+
+#ifdef __linux__
+SELENA_BENCH("process/supervisor_x8", [](const size_t n) {
+  selena::process_supervisor supervisor{};
+  selena::async_process procs[8];
+  for (size_t i{ 0 }; i < n; ++i) {
+    for (selena::async_process& p : procs) selena::bench::do_not_optimize(supervisor.start(true_argv, p));
+    supervisor.wait_all();
+  }
+});
+
+  #if __cplusplus >= 202002L && __has_include(<coroutine>)
+selena::task<void> coro_run_true(selena::event_loop& loop) {
+  selena::bench::do_not_optimize(co_await selena::async_run(loop, true_argv));
+}
+
+SELENA_BENCH("process/coro_x8", [](const size_t n) {
+  selena::event_loop loop{};
+  for (size_t i{ 0 }; i < n; ++i) {
+    for (int j{ 0 }; j < 8; ++j) loop.spawn(coro_run_true(loop));
+    loop.run();
+  }
+});
+  #endif // C++20
+#endif // __linux__
+} // namespace
+
+#endif // _WIN32
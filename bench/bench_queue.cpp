@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <cstdint>
+
+#include "bench.hpp"
+#include "queue.hpp"
+
+namespace {
+// "n" elements go through the queue, split across "pairs" producers and as many consumers, so
+// ops/s is the aggregate push+pop throughput. Full / empty queues yield instead of spinning hot.
+constexpr size_t capacity{ 1024 };
+constexpr size_t batch{ 16 };
+
+// What the pipeline used before: a std::deque behind a mutex
+class locked_queue {
+public:
+  explicit locked_queue(const size_t max) : _max{ max } {}
+
+  bool try_push(const uint64_t value) {
+    const std::lock_guard<std::mutex> lock{ _mutex };
+    if (_items.size() >= _max) return false;
+    _items.push_back(value);
+    return true;
+  }
+
+  bool try_pop(uint64_t& out) {
+    const std::lock_guard<std::mutex> lock{ _mutex };
+    if (_items.empty()) return false;
+    out = _items.front();
+    _items.pop_front();
+    return true;
+  }
+
+private:
+  const size_t _max;
+  std::mutex _mutex{};
+  std::deque<uint64_t> _items{};
+};
+
+template<typename Queue>
+void single(const size_t pairs, const size_t n) {
+  Queue queue{ capacity };
+  const size_t per_producer{ n / pairs + 1 };
+  std::atomic<size_t> consumed{ 0 };
+  selena::bench::run_threads(pairs * 2, [&](const size_t t) {
+    if (t < pairs) {
+      for (size_t i{ 0 }; i < per_producer;) {
+        if (queue.try_push(i)) ++i;
+        else std::this_thread::yield();
+      }
+    } else {
+      uint64_t value{ 0 };
+      while (consumed.load(std::memory_order_relaxed) < per_producer * pairs) {
+        if (queue.try_pop(value)) {
+          selena::bench::do_not_optimize(value);
+          consumed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+}
+
+template<typename Queue>
+void bulk(const size_t pairs, const size_t n) {
+  Queue queue{ capacity };
+  const size_t per_producer{ n / pairs + 1 };
+  std::atomic<size_t> consumed{ 0 };
+  selena::bench::run_threads(pairs * 2, [&](const size_t t) {
+    uint64_t items[batch]{};
+    if (t < pairs) {
+      for (size_t i{ 0 }; i < per_producer;) {
+        const size_t want{ per_producer - i < batch ? per_producer - i : batch };
+        const size_t pushed{ queue.try_push_bulk(items, want) };
+        if (pushed) i += pushed;
+        else std::this_thread::yield();
+      }
+    } else {
+      while (consumed.load(std::memory_order_relaxed) < per_producer * pairs) {
+        const size_t popped{ queue.try_pop_bulk(items, batch) };
+        if (popped) {
+          selena::bench::do_not_optimize(items[0]);
+          consumed.fetch_add(popped, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+}
+
+size_t half_threads() {
+  const size_t n{ std::thread::hardware_concurrency() / 2 };
+  return n ? n : 1;
+}
+
+SELENA_BENCH("queue/locked_deque/1p1c", [](const size_t n) { single<locked_queue>(1, n); });
+SELENA_BENCH("queue/locked_deque/all_threads", [](const size_t n) { single<locked_queue>(half_threads(), n); });
+SELENA_BENCH("queue/mpmc/1p1c", [](const size_t n) { single<selena::mpmc_queue<uint64_t>>(1, n); });
+SELENA_BENCH("queue/mpmc/all_threads", [](const size_t n) { single<selena::mpmc_queue<uint64_t>>(half_threads(), n); });
+SELENA_BENCH("queue/mpmc_bulk16/1p1c", [](const size_t n) { bulk<selena::mpmc_queue<uint64_t>>(1, n); });
+SELENA_BENCH("queue/mpmc_bulk16/all_threads", [](const size_t n) { bulk<selena::mpmc_queue<uint64_t>>(half_threads(), n); });
+SELENA_BENCH("queue/spsc/1p1c", [](const size_t n) { single<selena::spsc_queue<uint64_t>>(1, n); });
+SELENA_BENCH("queue/spsc_bulk16/1p1c", [](const size_t n) { bulk<selena::spsc_queue<uint64_t>>(1, n); });
+} // namespace
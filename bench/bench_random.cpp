@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#if __cplusplus >= 202002L && __has_include(<ranges>)
+  #include <ranges>
+#endif
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arena.hpp"
+#include "bench.hpp"
+#include "random.hpp"
+
+namespace {
+const std::vector<int> vec{ [] {
+  std::vector<int> v(1000);
+  std::iota(v.begin(), v.end(), 0);
+  return v;
+}() };
+
+// Way past the LLC, so every pick is a cache miss unless it's prefetched
+const std::vector<int>& large_vec() {
+  static const std::vector<int> v{ [] {
+    std::vector<int> ret(size_t{ 1 } << 25);
+    std::iota(ret.begin(), ret.end(), 0);
+    return ret;
+  }() };
+  return v;
+}
+
+const std::array<int, 64> arr{ [] {
+  std::array<int, 64> a{};
+  std::iota(a.begin(), a.end(), 0);
+  return a;
+}() };
+
+constexpr std::string_view hex{ "0123456789abcdef" };
+constexpr std::string_view base64url{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_" };
+constexpr std::string_view alnum{ base64url.substr(0, 62) }; // Not a power of two: rejection sampling
+
+// What random_string() replaces: a vector of chars per token, then a copy into a string
+const std::vector<char> alnum_vec{ alnum.begin(), alnum.end() };
+
+SELENA_BENCH("random/prng/vector", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random(vec));
+});
+
+SELENA_BENCH("random/prng/vector_x1000", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random(vec, 1000));
+});
+
+SELENA_BENCH("random/prng/vector_x1000_arena", [](const size_t n) {
+  selena::stack_arena<8192> arena{};
+  for (size_t i{ 0 }; i < n; ++i) {
+    selena::bench::do_not_optimize(selena::random_prng::random(vec, 1000, arena.resource()));
+    arena.reset();
+  }
+});
+
+SELENA_BENCH("random/prng/large_vector_x1000", [](const size_t n) {
+  const std::vector<int>& v{ large_vec() };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random(v, 1000));
+});
+
+// The same picks without the lookahead and prefetching: every miss is paid before the next index
+// is even drawn. Same engine, distribution and output vector as random(vec, count).
+std::vector<int> picks_no_lookahead(const std::vector<int>& v, const size_t count) {
+  static std::mt19937_64 engine{ std::random_device{}() };
+  std::uniform_int_distribution<size_t> distribution{ 0, v.size() - 1 };
+  std::vector<int> ret{};
+  ret.reserve(count);
+  for (size_t i{ 0 }; i < count; ++i) ret.push_back(v[distribution(engine)]);
+  return ret;
+}
+
+SELENA_BENCH("random/prng/large_vector_x1000/no_lookahead", [](const size_t n) {
+  const std::vector<int>& v{ large_vec() };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(picks_no_lookahead(v, 1000));
+});
+
+SELENA_BENCH("random/prng/array", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random(arr));
+});
+
+SELENA_BENCH("random/prng/array_x16", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random<16>(arr));
+});
+
+// A billion values which never exist in memory: O(count) either way
+SELENA_BENCH("random/prng/random_in_1e9_x1000", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random_in(0, 999'999'999, 1000));
+});
+
+SELENA_BENCH("random/prng/generated_1e9_x1000", [](const size_t n) {
+  const auto squares{ selena::generated(1'000'000'000, [](const size_t i) { return i * i; }) };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random(squares, 1000));
+});
+
+#if __cplusplus >= 202002L && __has_include(<ranges>)
+SELENA_BENCH("random/prng/iota_view_1e9_x1000", [](const size_t n) {
+  const auto values{ std::views::iota(0, 1'000'000'000) };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random(values, 1000));
+});
+#endif
+
+// Shuffling a 4M element vector in place, 16 MiB: past most L2s, so the random swaps miss
+std::vector<uint32_t>& shuffled() {
+  static std::vector<uint32_t> v{ [] {
+    std::vector<uint32_t> ret(1 << 22);
+    std::iota(ret.begin(), ret.end(), 0u);
+    return ret;
+  }() };
+  return v;
+}
+
+SELENA_BENCH("random/shuffle_4m/std_shuffle", [](const size_t n) {
+  static std::mt19937_64 engine{ std::random_device{}() };
+  for (size_t i{ 0 }; i < n; ++i) {
+    std::shuffle(shuffled().begin(), shuffled().end(), engine);
+    selena::bench::do_not_optimize(shuffled()[0]);
+  }
+});
+
+SELENA_BENCH("random/shuffle_4m/prng", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) {
+    selena::random_prng::shuffle(shuffled());
+    selena::bench::do_not_optimize(shuffled()[0]);
+  }
+});
+
+SELENA_BENCH("random/trng/vector", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_trng::random(vec));
+});
+
+SELENA_BENCH("random/trng/vector_x1000", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_trng::random(vec, 1000));
+});
+
+SELENA_BENCH("random/trng/array", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_trng::random(arr));
+});
+
+SELENA_BENCH("random/trng/array_x16", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_trng::random<16>(arr));
+});
+
+SELENA_BENCH("random/prng/token_hex32", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random_string(hex, 32));
+});
+
+SELENA_BENCH("random/prng/token_base64url22", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random_string(base64url, 22));
+});
+
+SELENA_BENCH("random/prng/token_alnum32", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random_string(alnum, 32));
+});
+
+SELENA_BENCH("random/prng/token_alnum32_into", [](const size_t n) {
+  char token[32];
+  for (size_t i{ 0 }; i < n; ++i) {
+    selena::random_prng::random_string_into(alnum, token, sizeof(token));
+    selena::bench::do_not_optimize(token[0]);
+  }
+});
+
+SELENA_BENCH("random/prng/token_alnum32_vector", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) {
+    const std::vector<char> chars{ selena::random_prng::random(alnum_vec, 32) };
+    selena::bench::do_not_optimize(std::string{ chars.begin(), chars.end() });
+  }
+});
+
+SELENA_BENCH("random/trng/token_base64url22", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_trng::random_string(base64url, 22));
+});
+
+SELENA_BENCH("random/trng/token_alnum32", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_trng::random_string(alnum, 32));
+});
+
+SELENA_BENCH("random/trng/token_alnum32_vector", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) {
+    const std::vector<char> chars{ selena::random_trng::random(alnum_vec, 32) };
+    selena::bench::do_not_optimize(std::string{ chars.begin(), chars.end() });
+  }
+});
+
+// Weighted sampling without replacement, across candidate counts and sample sizes. "picks_removal"
+// is the O(n * k) way: k weighted picks, each a scan of the running weights, zeroing the winner.
+std::vector<size_t> picks_removal(std::vector<double> weights, const size_t k) {
+  static std::mt19937_64 engine{ std::random_device{}() };
+  std::vector<size_t> ret{};
+  for (size_t pick{ 0 }; pick < k; ++pick) {
+    double total{ 0 };
+    for (const double w : weights) total += w;
+    double target{ std::uniform_real_distribution<double>{ 0, total }(engine) };
+    size_t i{ 0 };
+    while (i + 1 < weights.size() && (target -= weights[i]) >= 0) ++i;
+    ret.push_back(i);
+    weights[i] = 0;
+  }
+  return ret;
+}
+
+const bool weighted_registered{ [] {
+  for (const size_t candidates : { 1'000, 10'000, 100'000 }) {
+    std::vector<double> weights(candidates);
+    for (size_t i{ 0 }; i < candidates; ++i) weights[i] = 1.0 + static_cast<double>(i % 7);
+    for (const size_t k : { 1, 10, 100, 1'000 }) {
+      if (k > candidates / 10) continue;
+      const std::string name{ "random/weighted_sample/n" + std::to_string(candidates) + "_k" + std::to_string(k) };
+      selena::bench::registry().push_back({ name + "/indices", [weights, k](const size_t n) {
+        for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::weighted_sample(weights, k));
+      } });
+      selena::bench::registry().push_back({ name + "/stream", [weights, k](const size_t n) {
+        for (size_t i{ 0 }; i < n; ++i)
+          selena::bench::do_not_optimize(selena::random_prng::weighted_sample(weights.begin(), weights.end(), k, [](const double w) { return w; }));
+      } });
+      if (candidates * k <= 1'000'000) {
+        selena::bench::registry().push_back({ name + "/picks_removal", [weights, k](const size_t n) {
+          for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(picks_removal(weights, k));
+        } });
+      }
+    }
+  }
+  return true;
+}() };
+} // namespace
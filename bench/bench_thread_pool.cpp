@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <memory>
+#include <numeric>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+
+#include "bench.hpp"
+#include "random.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"
+
+namespace {
+// Scaling: the same bulk call on pools of 1, 2, 4 ... up to all hardware threads.
+// Pools are created once per size, outside of the timed part.
+selena::thread_pool& pool_of(const size_t threads) {
+  static std::map<size_t, std::unique_ptr<selena::thread_pool>> pools{};
+  std::unique_ptr<selena::thread_pool>& pool{ pools[threads] };
+  if (!pool) pool = std::make_unique<selena::thread_pool>(selena::thread_pool_options{ threads, false });
+  return *pool;
+}
+
+size_t all_threads() {
+  const size_t n{ std::thread::hardware_concurrency() };
+  return n ? n : 1;
+}
+
+const std::vector<int>& picks_from() {
+  static const std::vector<int> v{ [] {
+    std::vector<int> ret(1 << 16);
+    std::iota(ret.begin(), ret.end(), 0);
+    return ret;
+  }() };
+  return v;
+}
+
+const std::vector<std::string>& urls() {
+  static const std::vector<std::string> v{ [] {
+    std::vector<std::string> ret{};
+    for (size_t i{ 0 }; i < 100'000; ++i)
+      ret.push_back(i % 7 ? "https://example.com/some/path/" + std::to_string(i) + "?q=" + std::to_string(i * 31)
+                          : "https://example.com/$(rm -rf)/" + std::to_string(i));
+    return ret;
+  }() };
+  return v;
+}
+
+const std::vector<std::string>& emails() {
+  static const std::vector<std::string> v{ [] {
+    std::vector<std::string> ret{};
+    for (size_t i{ 0 }; i < 10'000; ++i) ret.push_back("user" + std::to_string(i) + (i % 3 ? "@example.com" : "@bad"));
+    return ret;
+  }() };
+  return v;
+}
+
+// One benchmark per pool size, from 1 doubling up to all hardware threads
+template<typename F>
+void register_scaling(const std::string& name, F fn) {
+  for (size_t threads{ 1 };; threads *= 2) {
+    const size_t t{ std::min(threads, all_threads()) };
+    selena::bench::registry().push_back({ name + "/x" + std::to_string(t), [t, fn](const size_t n) { fn(pool_of(t), n); } });
+    if (t == all_threads()) break;
+  }
+}
+
+const bool registered{ [] {
+  register_scaling("thread_pool/parallel_for_sum_1m", [](selena::thread_pool& pool, const size_t n) {
+    static const std::vector<uint64_t> data(1 << 20, 3);
+    for (size_t i{ 0 }; i < n; ++i) {
+      std::atomic<uint64_t> total{ 0 };
+      pool.parallel_for(0, data.size(), [&](const size_t begin, const size_t end) {
+        uint64_t sum{ 0 };
+        for (size_t j{ begin }; j < end; ++j) sum += data[j];
+        total.fetch_add(sum, std::memory_order_relaxed);
+      });
+      selena::bench::do_not_optimize(total.load());
+    }
+  });
+
+  register_scaling("thread_pool/prng_random_x1m", [](selena::thread_pool& pool, const size_t n) {
+    for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::random_prng::random(picks_from(), 1'000'000, pool));
+  });
+
+  register_scaling("thread_pool/prng_shuffle_4m", [](selena::thread_pool& pool, const size_t n) {
+    static std::vector<uint32_t> data{ [] {
+      std::vector<uint32_t> ret(1 << 22);
+      std::iota(ret.begin(), ret.end(), 0u);
+      return ret;
+    }() };
+    for (size_t i{ 0 }; i < n; ++i) {
+      selena::random_prng::shuffle(data, pool);
+      selena::bench::do_not_optimize(data[0]);
+    }
+  });
+
+  register_scaling("thread_pool/is_valid_url_x100k", [](selena::thread_pool& pool, const size_t n) {
+    for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::is_valid_url(urls(), pool));
+  });
+
+  register_scaling("thread_pool/is_valid_format_x10k", [](selena::thread_pool& pool, const size_t n) {
+    static const std::regex email{ R"([a-z0-9._%+-]+@[a-z0-9.-]+\.[a-z]{2,})" };
+    for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::is_valid_format(emails(), email, pool));
+  });
+  return true;
+}() };
+} // namespace
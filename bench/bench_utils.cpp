@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <regex>
+#include <string>
+#include <string_view>
+
+#include <cstdlib>
+
+#include "arena.hpp"
+#include "bench.hpp"
+#include "utils.hpp"
+
+namespace {
+const std::string email{ "someone.important@example.co.uk" };
+const std::string email_pattern{ R"([\w.+-]+@[\w-]+(\.[\w-]+)+)" };
+const std::regex email_regex{ email_pattern };
+
+const std::string good_url{ "https://www.example.com/some/long/path/to/a/resource?with=query&and=more#fragment" };
+const std::string good_url_upper{ "HTTPS://WWW.EXAMPLE.COM/SOME/LONG/PATH/TO/A/RESOURCE?WITH=QUERY&AND=MORE#FRAGMENT" };
+const std::string bad_url{ "https://www.example.com/some/long/path/to/a/resource?with=query&and=$more" };
+
+const std::string_view haystack{
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore "
+  "et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris NEEDLE nisi"
+};
+
+SELENA_BENCH("utils/is_valid_format/string_pattern", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::is_valid_format(email, email_pattern));
+});
+
+SELENA_BENCH("utils/is_valid_format/regex", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::is_valid_format(email, email_regex));
+});
+
+SELENA_BENCH("utils/is_valid_url/valid", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::is_valid_url(good_url));
+});
+
+SELENA_BENCH("utils/is_valid_url/invalid", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::is_valid_url(bad_url));
+});
+
+SELENA_BENCH("utils/getenv", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::getenv("PATH"));
+});
+
+SELENA_BENCH("utils/getenv_arena", [](const size_t n) {
+  selena::stack_arena<4096> arena{};
+  for (size_t i{ 0 }; i < n; ++i) {
+    selena::bench::do_not_optimize(selena::getenv("PATH", arena.resource()));
+    arena.reset();
+  }
+});
+
+SELENA_BENCH("utils/iequal", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) {
+    const unsigned char c{ static_cast<unsigned char>('A' + (i & 15)) };
+    selena::bench::do_not_optimize(selena::iequal(c, static_cast<unsigned char>(c | 0x20)));
+  }
+});
+
+SELENA_BENCH("utils/iequal_str", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::iequal_str(good_url, good_url_upper));
+});
+
+SELENA_BENCH("utils/icontains/hit", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::icontains(haystack, "needle"));
+});
+
+SELENA_BENCH("utils/icontains/miss", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::icontains(haystack, "haystack"));
+});
+
+SELENA_BENCH("utils/system", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::system("true"));
+});
+
+SELENA_BENCH("utils/system_suppressed", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::system_suppressed("echo hello"));
+});
+
+// What system_suppressed() used to do: a shell doing the redirection, through std::system()
+SELENA_BENCH("utils/system_suppressed/std_system", [](const size_t n) {
+  const char* const cmd{ "echo hello" };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(std::system((std::string{ cmd } + " > /dev/null 2>&1").c_str()));
+});
+} // namespace
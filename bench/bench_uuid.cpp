@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "uuid.hpp"
+
+namespace {
+size_t all_threads() {
+  const size_t n{ std::thread::hardware_concurrency() };
+  return n ? n : 1;
+}
+
+SELENA_BENCH("uuid/v4/prng", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::uuid_v4());
+});
+
+SELENA_BENCH("uuid/v4/trng", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::uuid_v4<selena::random_trng>());
+});
+
+SELENA_BENCH("uuid/v7/prng", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::uuid_v7());
+});
+
+// "n" IDs split across every hardware thread: ops/s is the aggregate, divide by the thread count for per core
+SELENA_BENCH("uuid/v7/prng_all_threads", [](const size_t n) {
+  const size_t threads{ all_threads() };
+  selena::bench::run_threads(threads, [&](size_t) {
+    for (size_t i{ 0 }; i < n / threads + 1; ++i) selena::bench::do_not_optimize(selena::uuid_v7());
+  });
+});
+
+SELENA_BENCH("uuid/v7/trng", [](const size_t n) {
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::uuid_v7<selena::random_trng>());
+});
+
+// A rotating set, so nothing about the input can be hoisted out of the loop
+const std::vector<selena::uuid>& ids() {
+  static const std::vector<selena::uuid> v{ [] {
+    std::vector<selena::uuid> ret(64);
+    for (selena::uuid& id : ret) id = selena::uuid_v4();
+    return ret;
+  }() };
+  return v;
+}
+
+const std::vector<std::string>& texts() {
+  static const std::vector<std::string> v{ [] {
+    std::vector<std::string> ret{};
+    for (const selena::uuid& id : ids()) ret.push_back(id.to_string());
+    return ret;
+  }() };
+  return v;
+}
+
+SELENA_BENCH("uuid/to_chars", [](const size_t n) {
+  const std::vector<selena::uuid>& v{ ids() };
+  char text[selena::uuid::string_size];
+  for (size_t i{ 0 }; i < n; ++i) {
+    v[i & 63].to_chars(text);
+    selena::bench::do_not_optimize(text);
+  }
+});
+
+SELENA_BENCH("uuid/to_string", [](const size_t n) {
+  const std::vector<selena::uuid>& v{ ids() };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(v[i & 63].to_string());
+});
+
+SELENA_BENCH("uuid/parse", [](const size_t n) {
+  const std::vector<std::string>& v{ texts() };
+  for (size_t i{ 0 }; i < n; ++i) selena::bench::do_not_optimize(selena::uuid::parse(v[i & 63]));
+});
+} // namespace
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench.hpp"
+
+namespace {
+void usage(const char* const argv0) {
+  std::printf("Usage: %s [--filter substr] [--samples n] [--min-sample-ms n] [--warmup-ms n] [--json file|-] [--list]\n", argv0);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  selena::bench::config cfg{};
+  const char* json_path{ nullptr };
+  bool list{ false };
+
+  for (int i{ 1 }; i < argc; ++i) {
+    const char* const arg{ argv[i] };
+    const bool has_value{ i + 1 < argc };
+    if (!std::strcmp(arg, "--filter") && has_value) cfg.filter = argv[++i];
+    else if (!std::strcmp(arg, "--samples") && has_value) cfg.samples = std::strtoull(argv[++i], nullptr, 10);
+    else if (!std::strcmp(arg, "--min-sample-ms") && has_value) cfg.min_sample_ns = std::strtoull(argv[++i], nullptr, 10) * 1'000'000;
+    else if (!std::strcmp(arg, "--warmup-ms") && has_value) cfg.warmup_ns = std::strtoull(argv[++i], nullptr, 10) * 1'000'000;
+    else if (!std::strcmp(arg, "--json") && has_value) json_path = argv[++i];
+    else if (!std::strcmp(arg, "--list")) list = true;
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (!cfg.samples) cfg.samples = 1;
+
+  std::vector<selena::bench::result> results{};
+  // The JSON can go to stdout, in which case the table goes to stderr
+  std::FILE* const table{ json_path && !std::strcmp(json_path, "-") ? stderr : stdout };
+  if (!list) selena::bench::print_table_header(table);
+
+  // Registration order across translation units is unspecified, keep the output stable
+  std::vector<selena::bench::benchmark>& benchmarks{ selena::bench::registry() };
+  std::stable_sort(benchmarks.begin(), benchmarks.end(),
+    [](const selena::bench::benchmark& a, const selena::bench::benchmark& b) { return a.name < b.name; });
+
+  for (const selena::bench::benchmark& b : benchmarks) {
+    if (!cfg.filter.empty() && b.name.find(cfg.filter) == std::string::npos) continue;
+    if (list) {
+      std::printf("%s\n", b.name.c_str());
+      continue;
+    }
+    results.push_back(selena::bench::run(b, cfg));
+    selena::bench::print_table_row(table, results.back());
+    std::fflush(table);
+  }
+
+  if (json_path) {
+    std::FILE* const out{ !std::strcmp(json_path, "-") ? stdout : std::fopen(json_path, "w") };
+    if (!out) {
+      std::perror(json_path);
+      return 1;
+    }
+    selena::bench::write_json(out, results);
+    if (out != stdout) std::fclose(out);
+  }
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_ARENA_HPP
+#define SELENA_ARENA_HPP
+
+// Monotonic (bump) allocator for request-scoped work.
+// Allocating is a pointer bump; freeing individual allocations is a no-op. reset() hands all the
+// memory back at once in O(1) and keeps the blocks around, so a reused arena stops touching the
+// heap after its first few rounds. Works with anything taking a std::pmr::memory_resource*, incl.
+// the allocator-aware overloads in utils.hpp and random.hpp:
+//   selena::stack_arena<4096> a{};
+//   const std::pmr::string home{ selena::getenv("HOME", a.resource()) };
+//   ...
+//   a.reset();
+// Not thread-safe - use one arena per thread (or per request).
+
+#include <memory_resource>
+#include <new>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base.hpp"
+
+namespace selena {
+class arena {
+public:
+  static constexpr size_t default_block_size{ 4096 };
+  static constexpr size_t max_block_size{ size_t{ 1 } << 20 };
+
+  /*
+   * @param block_size Size of the first heap block. Later ones double, up to max_block_size.
+   * @param upstream Where the blocks come from
+   */
+  explicit arena(const size_t block_size = default_block_size,
+    std::pmr::memory_resource* const upstream = std::pmr::get_default_resource()) :
+    _next_size{ block_size ? block_size : default_block_size }, _upstream{ upstream } {}
+
+  /*
+   * Usage: "char buf[1024]; selena::arena a{ buf, sizeof(buf) };" - or see selena::stack_arena.
+   * @param buffer Used before any heap block. Must outlive the arena.
+   * @param size Size of "buffer" in bytes
+   * @param upstream Where the blocks come from, once "buffer" is used up
+   */
+  arena(void* const buffer, const size_t size,
+    std::pmr::memory_resource* const upstream = std::pmr::get_default_resource()) :
+    _initial{ static_cast<std::byte*>(buffer) }, _initial_size{ size }, _ptr{ _initial }, _end{ _initial + size },
+    _next_size{ size > default_block_size ? size : default_block_size }, _upstream{ upstream } {}
+
+  ~arena() { release(); }
+
+  // The resource adapter points back into the arena
+  NO_COPY_MOVE(arena)
+
+  /*
+   * @param bytes Number of bytes
+   * @param align Power of two
+   * @returns void* Never nullptr - throws std::bad_alloc instead (from upstream, or for a size no block could hold)
+   */
+  [[nodiscard]] FORCE_INLINE void* allocate(const size_t bytes, const size_t align = alignof(std::max_align_t)) {
+    std::byte* const p{ _impl_align_up(_ptr, align) };
+    // Aligning can step past the end of the block
+    if (LIKELY(p && p <= _end && bytes <= static_cast<size_t>(_end - p))) {
+      _ptr = p + bytes;
+      return p;
+    }
+    return _impl_allocate_slow(bytes, align);
+  }
+
+  // Forgets every allocation. Blocks are kept and reused in order. O(1).
+  void reset() noexcept {
+    _current = nullptr;
+    _ptr = _initial;
+    _end = _initial + _initial_size;
+  }
+
+  // Like reset(), but also gives the heap blocks back to upstream
+  void release() noexcept {
+    for (_impl_block* block{ _blocks }; block;) {
+      _impl_block* const next{ block->next };
+      _upstream->deallocate(block, sizeof(_impl_block) + block->size, alignof(_impl_block));
+      block = next;
+    }
+    _blocks = _last = nullptr;
+    reset();
+  }
+
+  // Total bytes held from upstream, excl. the initial buffer
+  [[nodiscard]] size_t heap_capacity() const noexcept {
+    size_t total{ 0 };
+    for (const _impl_block* block{ _blocks }; block; block = block->next) total += block->size;
+    return total;
+  }
+
+  // For std::pmr containers. deallocate() through it is a no-op, reset() the arena instead.
+  [[nodiscard]] std::pmr::memory_resource* resource() noexcept { return &_resource; }
+
+private:
+  struct alignas(std::max_align_t) _impl_block {
+    _impl_block* next;
+    size_t size; // Usable bytes after the header
+    std::byte* data() { return reinterpret_cast<std::byte*>(this + 1); }
+  };
+
+  class _impl_resource final : public std::pmr::memory_resource {
+  public:
+    explicit _impl_resource(arena& owner) : _owner{ owner } {}
+
+  private:
+    void* do_allocate(const size_t bytes, const size_t align) override { return _owner.allocate(bytes, align); }
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    arena& _owner;
+  };
+
+  FORCE_INLINE static std::byte* _impl_align_up(std::byte* const p, const size_t align) {
+    const uintptr_t addr{ reinterpret_cast<uintptr_t>(p) };
+    return reinterpret_cast<std::byte*>((addr + align - 1) & ~(uintptr_t{ align } - 1));
+  }
+
+  // Moves on to the next block which fits, reusing the ones kept by reset() before asking upstream
+  NOINLINE void* _impl_allocate_slow(const size_t bytes, const size_t align) {
+    // Too large for the block size (plus header and alignment slack) to fit in a size_t
+    if (UNLIKELY(bytes > SIZE_MAX - align - sizeof(_impl_block))) throw std::bad_alloc{};
+    const size_t needed{ bytes + (align > alignof(std::max_align_t) ? align : 0) };
+    _impl_block* block{ _current ? _current->next : _blocks };
+    while (block && block->size < needed) block = block->next;
+
+    if (!block) {
+      const size_t size{ needed > _next_size ? needed : _next_size };
+      block = static_cast<_impl_block*>(_upstream->allocate(sizeof(_impl_block) + size, alignof(_impl_block)));
+      block->next = nullptr;
+      block->size = size;
+      if (_last) _last->next = block;
+      else _blocks = block;
+      _last = block;
+      if (_next_size < max_block_size) _next_size *= 2;
+    }
+
+    _current = block;
+    std::byte* const p{ _impl_align_up(block->data(), align) };
+    _ptr = p + bytes;
+    _end = block->data() + block->size;
+    return p;
+  }
+
+  std::byte* _initial{ nullptr };
+  size_t _initial_size{ 0 };
+  std::byte* _ptr{ nullptr };
+  std::byte* _end{ nullptr };
+
+  _impl_block* _blocks{ nullptr }; // In allocation order
+  _impl_block* _last{ nullptr };
+  _impl_block* _current{ nullptr }; // nullptr: still in the initial buffer
+  size_t _next_size;
+
+  std::pmr::memory_resource* _upstream;
+  _impl_resource _resource{ *this };
+}; // class arena
+
+// An arena with its first "N" bytes inline - on the stack when declared as a local.
+template<size_t N>
+class stack_arena : public arena {
+public:
+  explicit stack_arena(std::pmr::memory_resource* const upstream = std::pmr::get_default_resource()) :
+    arena{ _buffer, N, upstream } {}
+
+private:
+  alignas(std::max_align_t) std::byte _buffer[N];
+}; // class stack_arena
+} // namespace selena
+
+#endif // SELENA_ARENA_HPP
@@ -0,0 +1,464 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_ASYNC_PROCESS_HPP
+#define SELENA_ASYNC_PROCESS_HPP
+
+// Linux only - built on pidfd_open(2) and epoll(7).
+#ifdef __linux__
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "base.hpp"
+#include "process.hpp"
+
+namespace selena {
+// Caller-owned storage for captured output. Nothing is allocated on the caller's behalf:
+// once "capacity" bytes have been stored, the rest is read and dropped and "truncated" is set.
+struct capture_buffer {
+  char* data{ nullptr };
+  size_t capacity{ 0 };
+  size_t size{ 0 };
+  bool truncated{ false };
+};
+
+struct async_options {
+  spawn_options spawn{};
+  // Captures stdout / stderr into the given buffers. Must outlive the process.
+  capture_buffer* out{ nullptr };
+  capture_buffer* err{ nullptr };
+  // Streams stdout / stderr into these fds with splice(2) - no copy through userspace - or with
+  // read() / write() where splice() refuses the fd (ttys, O_APPEND files). Takes precedence over
+  // "out" / "err". A sink which is full (a non-blocking pipe or socket) pauses its stream until
+  // it's writable again.
+  int out_fd{ -1 };
+  int err_fd{ -1 };
+  // The child is SIGKILL'ed once this elapses. Zero means no timeout.
+  std::chrono::milliseconds timeout{ 0 };
+};
+
+namespace detail {
+inline int _impl_pidfd_send_signal(const int pidfd, const int sig) {
+  return static_cast<int>(::syscall(SYS_pidfd_send_signal, pidfd, sig, nullptr, 0));
+}
+
+struct _impl_async_child;
+
+// What an epoll event points at: the child, and which of its fds fired.
+struct _impl_async_source {
+  _impl_async_child* child{ nullptr };
+  int kind{ 0 }; // 0 - stdout, 1 - stderr, 2 - pidfd, 3 / 4 - the stdout / stderr sink, while it's full
+};
+
+struct _impl_async_child {
+  pid_t pid{ -1 };
+  int pidfd{ -1 };
+  int pipes[2]{ -1, -1 }; // Read ends, stdout / stderr
+  int sinks[2]{ -1, -1 };
+  // A dup() of the sink, watched for EPOLLOUT while it's full (epoll keys on the fd, and several
+  // streams can share a sink)
+  int sink_watches[2]{ -1, -1 };
+  bool copying[2]{ false, false }; // splice() refused the sink, read() / write() instead
+  std::string pending[2]{};        // Read, but not yet written to the sink
+  capture_buffer* buffers[2]{ nullptr, nullptr };
+  size_t spliced[2]{ 0, 0 };
+  _impl_async_source sources[5]{};
+
+  bool has_deadline{ false };
+  std::chrono::steady_clock::time_point deadline{};
+
+  int status{ -1 };
+  bool exited{ false }; // Reaping waits for a paused stream to catch up
+  bool finished{ false };
+  bool timed_out{ false };
+  bool cancelled{ false };
+};
+} // namespace detail
+
+/*
+ * Handle to a process started by selena::process_supervisor. Cheap to copy; acts as the "future".
+ * It only changes state while the owning supervisor's poll() / wait() runs.
+ */
+class async_process {
+public:
+  async_process() = default;
+
+  [[nodiscard]] bool valid() const { return static_cast<bool>(_state); }
+  [[nodiscard]] bool done() const { return _state && _state->finished; }
+  [[nodiscard]] pid_t pid() const { return _state ? _state->pid : -1; }
+  // The wait status, same as std::system(). -1 until done().
+  [[nodiscard]] int status() const { return _state ? _state->status : -1; }
+  [[nodiscard]] bool timed_out() const { return _state && _state->timed_out; }
+  [[nodiscard]] bool cancelled() const { return _state && _state->cancelled; }
+  // Bytes streamed into "out_fd" / "err_fd" so far
+  [[nodiscard]] size_t out_spliced() const { return _state ? _state->spliced[0] : 0; }
+  [[nodiscard]] size_t err_spliced() const { return _state ? _state->spliced[1] : 0; }
+
+private:
+  friend class process_supervisor;
+  std::shared_ptr<detail::_impl_async_child> _state{};
+}; // class async_process
+
+/*
+ * Supervises any number of child processes from a single thread: one epoll instance watches
+ * every child's pidfd and output pipes. Not thread-safe - start(), poll() etc. are expected
+ * to be called from the thread owning the supervisor.
+ * Whatever is still running when the supervisor is destroyed is SIGKILL'ed and reaped.
+ */
+class process_supervisor {
+public:
+  process_supervisor() : _epoll_fd{ ::epoll_create1(EPOLL_CLOEXEC) } {}
+
+  ~process_supervisor() {
+    for (const std::shared_ptr<detail::_impl_async_child>& child : _children) {
+      detail::_impl_pidfd_send_signal(child->pidfd, SIGKILL);
+      _reap(*child);
+    }
+    if (_epoll_fd != -1) ::close(_epoll_fd);
+  }
+
+  NO_COPY_MOVE(process_supervisor)
+
+  // false if epoll_create1() failed, in which case start() always fails
+  [[nodiscard]] bool ok() const { return _epoll_fd != -1; }
+  [[nodiscard]] size_t running() const { return _children.size(); }
+
+  /*
+   * Starts a process without going through a shell. Doesn't block.
+   * @param argv A nullptr-terminated argument vector, argv[0] being the program
+   * @param proc Receives the handle on success
+   * @param opts See selena::async_options
+   * @returns int 0 on success, otherwise an errno value
+   */
+  [[nodiscard]] int start(const char* const* const argv, async_process& proc, const async_options& opts = {}) {
+    if (_epoll_fd == -1) return EBADF;
+
+    std::shared_ptr<detail::_impl_async_child> child{ std::make_shared<detail::_impl_async_child>() };
+    child->sinks[0] = opts.out_fd;
+    child->sinks[1] = opts.err_fd;
+    child->buffers[0] = opts.out;
+    child->buffers[1] = opts.err;
+
+    spawn_options spawn_opts{ opts.spawn };
+    int write_ends[2]{ -1, -1 };
+    for (int k{ 0 }; k < 2; ++k) {
+      if (child->sinks[k] == -1 && !child->buffers[k]) continue;
+      int fds[2];
+      if (::pipe2(fds, O_CLOEXEC) == -1) {
+        const int err{ errno };
+        _close_all(*child, write_ends);
+        return err;
+      }
+      ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+      child->pipes[k] = fds[0];
+      write_ends[k] = fds[1];
+    }
+    spawn_opts.stdout_fd = write_ends[0] != -1 ? write_ends[0] : spawn_opts.stdout_fd;
+    spawn_opts.stderr_fd = write_ends[1] != -1 ? write_ends[1] : spawn_opts.stderr_fd;
+
+    const int spawn_err{ spawn(argv, child->pid, spawn_opts) };
+    for (int& fd : write_ends) {
+      if (fd != -1) ::close(fd);
+      fd = -1;
+    }
+    if (spawn_err) {
+      _close_all(*child, write_ends);
+      return spawn_err;
+    }
+
+    child->pidfd = detail::_impl_pidfd_open(child->pid);
+    if (child->pidfd == -1) {
+      const int err{ errno };
+      ::kill(child->pid, SIGKILL);
+      _reap(*child);
+      return err;
+    }
+
+    for (int k{ 0 }; k < 5; ++k) child->sources[k] = { child.get(), k };
+    for (int k{ 0 }; k < 3; ++k) {
+      const int fd{ k == 2 ? child->pidfd : child->pipes[k] };
+      if (fd == -1) continue;
+      epoll_event ev{};
+      ev.events = EPOLLIN;
+      ev.data.ptr = &child->sources[k];
+      if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        const int err{ errno };
+        detail::_impl_pidfd_send_signal(child->pidfd, SIGKILL);
+        _reap(*child);
+        return err;
+      }
+    }
+
+    if (opts.timeout.count() > 0) {
+      child->has_deadline = true;
+      child->deadline = std::chrono::steady_clock::now() + opts.timeout;
+    }
+
+    proc._state = child;
+    _children.push_back(std::move(child));
+    return 0;
+  }
+
+  /*
+   * Asks a running process to stop.
+   * @param proc A handle returned by start()
+   * @param sig The signal to deliver, SIGTERM by default
+   * @returns int 0 on success, otherwise an errno value (ESRCH if it already finished)
+   */
+  int cancel(const async_process& proc, const int sig = SIGTERM) {
+    if (!proc._state || proc._state->finished) return ESRCH;
+    if (detail::_impl_pidfd_send_signal(proc._state->pidfd, sig) == -1) return errno;
+    proc._state->cancelled = true;
+    return 0;
+  }
+
+  /*
+   * Moves output into its buffers / sinks, reaps exited children and enforces timeouts.
+   * @param timeout_ms How long to block waiting for something to happen. -1 blocks indefinitely
+   * (bounded by the nearest process timeout), 0 doesn't block at all.
+   * @returns int Number of processes which finished during this call, or -1 on error
+   */
+  int poll(const int timeout_ms = -1) {
+    if (_epoll_fd == -1) return -1;
+    if (_children.empty()) return 0;
+
+    int wait_ms{ timeout_ms };
+    const std::chrono::steady_clock::time_point now{ std::chrono::steady_clock::now() };
+    for (const std::shared_ptr<detail::_impl_async_child>& child : _children) {
+      if (!child->has_deadline) continue;
+      const long long left{ std::chrono::ceil<std::chrono::milliseconds>(child->deadline - now).count() };
+      const int left_ms{ static_cast<int>(std::clamp<long long>(left, 0, 1 << 30)) };
+      if (wait_ms < 0 || left_ms < wait_ms) wait_ms = left_ms;
+    }
+
+    epoll_event events[64];
+    const int n{ ::epoll_wait(_epoll_fd, events, 64, wait_ms) };
+    if (n == -1 && errno != EINTR) return -1;
+
+    for (int i{ 0 }; i < n; ++i) {
+      const detail::_impl_async_source* const src{ static_cast<detail::_impl_async_source*>(events[i].data.ptr) };
+      detail::_impl_async_child& child{ *src->child };
+      if (child.finished) continue;
+      if (src->kind == 2) _exited(child);
+      else if (src->kind > 2) _resume(child, src->kind - 3);
+      else if (child.pipes[src->kind] != -1 && _drain(child, src->kind)) _close_pipe(child, src->kind);
+    }
+
+    const std::chrono::steady_clock::time_point after{ std::chrono::steady_clock::now() };
+    for (const std::shared_ptr<detail::_impl_async_child>& child : _children) {
+      if (child->finished || !child->has_deadline || child->deadline > after) continue;
+      child->has_deadline = false; // Deliver only once, the pidfd reports the exit afterwards
+      child->timed_out = true;
+      detail::_impl_pidfd_send_signal(child->pidfd, SIGKILL);
+    }
+
+    const size_t before{ _children.size() };
+    _children.erase(std::remove_if(_children.begin(), _children.end(),
+      [](const std::shared_ptr<detail::_impl_async_child>& child) { return child->finished; }), _children.end());
+    return static_cast<int>(before - _children.size());
+  }
+
+  // Blocks until the given process is done. Returns its wait status, or -1.
+  int wait(const async_process& proc) {
+    while (proc._state && !proc._state->finished)
+      if (poll(-1) == -1) return -1;
+    return proc.status();
+  }
+
+  // Blocks until every supervised process is done.
+  void wait_all() {
+    while (!_children.empty())
+      if (poll(-1) == -1) return;
+  }
+
+private:
+  // Returns true once the write end is closed (EOF) or the pipe is unusable. Returns false with
+  // the stream paused if the sink is full, see _pause().
+  bool _drain(detail::_impl_async_child& child, const int k) {
+    if (child.sink_watches[k] != -1) return false;
+    const int fd{ child.pipes[k] };
+    char scratch[4096];
+    if (!child.pending[k].empty()) {
+      const int err{ _flush(child, k) };
+      if (err) return err != EAGAIN || !_pause(child, k);
+    }
+    for (;;) {
+      ssize_t got{ 0 };
+      if (child.sinks[k] != -1 && !child.copying[k]) {
+        got = ::splice(fd, nullptr, child.sinks[k], nullptr, 1 << 16, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (got > 0) child.spliced[k] += static_cast<size_t>(got);
+        else if (got == -1 && errno == EINVAL) { // ttys, O_APPEND files, ...
+          child.copying[k] = true;
+          continue;
+        } else if (got == -1 && errno == EAGAIN) {
+          // Either end can be the one which would block: the sink is full if the pipe isn't empty
+          int available{ 0 };
+          if (::ioctl(fd, FIONREAD, &available) == 0 && available > 0) return !_pause(child, k);
+          return false;
+        }
+      } else if (child.sinks[k] != -1) {
+        got = ::read(fd, scratch, sizeof(scratch));
+        if (got > 0) {
+          child.pending[k].assign(scratch, static_cast<size_t>(got));
+          const int err{ _flush(child, k) };
+          if (err) return err != EAGAIN || !_pause(child, k);
+        }
+      } else {
+        capture_buffer& buf{ *child.buffers[k] };
+        const bool full{ buf.size >= buf.capacity };
+        got = full ? ::read(fd, scratch, sizeof(scratch)) : ::read(fd, buf.data + buf.size, buf.capacity - buf.size);
+        if (got > 0) {
+          if (full) buf.truncated = true;
+          else buf.size += static_cast<size_t>(got);
+        }
+      }
+      if (got > 0) continue;
+      if (!got) return true;
+      if (errno == EINTR) continue;
+      return errno != EAGAIN;
+    }
+  }
+
+  // Writes out "pending". 0 once it's empty, otherwise an errno value (EAGAIN: the sink is full).
+  static int _flush(detail::_impl_async_child& child, const int k) {
+    std::string& pending{ child.pending[k] };
+    size_t written{ 0 };
+    while (written < pending.size()) {
+      const ssize_t put{ ::write(child.sinks[k], pending.data() + written, pending.size() - written) };
+      if (put == -1) {
+        if (errno == EINTR) continue;
+        const int err{ errno };
+        pending.erase(0, written);
+        child.spliced[k] += written;
+        return err;
+      }
+      written += static_cast<size_t>(put);
+    }
+    child.spliced[k] += written;
+    pending.clear();
+    return 0;
+  }
+
+  // The sink is full: stop watching the pipe, which stays readable and would fire again right
+  // away, and watch the sink for EPOLLOUT instead. false if it can't be watched.
+  bool _pause(detail::_impl_async_child& child, const int k) {
+    const int watch{ ::fcntl(child.sinks[k], F_DUPFD_CLOEXEC, 0) };
+    if (watch == -1) return false;
+    epoll_event ev{};
+    ev.events = EPOLLOUT;
+    ev.data.ptr = &child.sources[3 + k];
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, watch, &ev) == -1) {
+      ::close(watch);
+      return false;
+    }
+    epoll_event paused{};
+    paused.data.ptr = &child.sources[k];
+    ::epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, child.pipes[k], &paused);
+    child.sink_watches[k] = watch;
+    return true;
+  }
+
+  // The sink is writable again: back to watching the pipe, after moving what's already in it
+  void _resume(detail::_impl_async_child& child, const int k) {
+    if (child.sink_watches[k] == -1) return; // Already resumed by an earlier event of the same batch
+    _unwatch_sink(child, k);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &child.sources[k];
+    ::epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, child.pipes[k], &ev);
+    if (_drain(child, k)) _close_pipe(child, k);
+    if (child.exited) _exited(child);
+  }
+
+  // Reaps the child, unless a full sink has its output on hold: then that catches up first
+  void _exited(detail::_impl_async_child& child) {
+    for (int k{ 0 }; k < 2; ++k)
+      if (child.pipes[k] != -1 && _drain(child, k)) _close_pipe(child, k);
+    if (child.sink_watches[0] == -1 && child.sink_watches[1] == -1) {
+      _reap(child);
+      return;
+    }
+    if (child.exited) return;
+    child.exited = true;
+    child.has_deadline = false; // Nothing left to time out
+    epoll_event ev{}; // The pidfd stays readable: stop watching it meanwhile
+    ev.data.ptr = &child.sources[2];
+    ::epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, child.pidfd, &ev);
+  }
+
+  void _unwatch_sink(detail::_impl_async_child& child, const int k) {
+    if (child.sink_watches[k] == -1) return;
+    ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, child.sink_watches[k], nullptr);
+    ::close(child.sink_watches[k]);
+    child.sink_watches[k] = -1;
+  }
+
+  void _close_pipe(detail::_impl_async_child& child, const int k) {
+    _unwatch_sink(child, k);
+    ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, child.pipes[k], nullptr);
+    ::close(child.pipes[k]);
+    child.pipes[k] = -1;
+  }
+
+  void _reap(detail::_impl_async_child& child) {
+    child.status = detail::_impl_waitpid(child.pid);
+    // Whatever the child wrote right before exiting is still sitting in the pipes. Grab it,
+    // but don't wait around for EOF - a grandchild could be holding the write end open.
+    for (int k{ 0 }; k < 2; ++k) {
+      if (child.pipes[k] == -1) continue;
+      _drain(child, k);
+      _close_pipe(child, k);
+    }
+    if (child.pidfd != -1) {
+      ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, child.pidfd, nullptr);
+      ::close(child.pidfd);
+      child.pidfd = -1;
+    }
+    child.finished = true;
+  }
+
+  static void _close_all(detail::_impl_async_child& child, const int (&write_ends)[2]) {
+    for (int k{ 0 }; k < 2; ++k) {
+      if (child.pipes[k] != -1) ::close(child.pipes[k]);
+      if (write_ends[k] != -1) ::close(write_ends[k]);
+      child.pipes[k] = -1;
+    }
+  }
+
+  int _epoll_fd{ -1 };
+  std::vector<std::shared_ptr<detail::_impl_async_child>> _children{};
+}; // class process_supervisor
+} // namespace selena
+
+#endif // __linux__
+
+#endif // SELENA_ASYNC_PROCESS_HPP
@@ -23,6 +23,8 @@
 // Also, don't panic if "Function definition for 'NO_COPY_MOVE' not found."  or smtg similar occurs.
 // Copy/move is blocked when this is used.
 // IntelliSense does that sometimes.
+// For a single handle which should still be movable (into containers, out of functions), see
+// selena::unique_handle in handle.hpp instead.
 #define NO_COPY(ClassName) \
   ClassName(const ClassName&) = delete; \
   ClassName& operator=(const ClassName&) = delete;
@@ -45,4 +47,85 @@
   #define NOINLINE
 #endif
 
+// The opposite of NOINLINE. Still just a (strong) hint on some compilers.
+#if defined(_MSC_VER)
+  #define FORCE_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+  #define FORCE_INLINE inline __attribute__((always_inline))
+#else
+  #define FORCE_INLINE inline
+#endif
+
+// Usage: "if (UNLIKELY(ptr == nullptr)) return;"
+// Only worth it where profiling says the branch is mispredicted or the cold side bloats the hot loop.
+#if defined(__GNUC__) || defined(__clang__)
+  #define LIKELY(x) __builtin_expect(!!(x), 1)
+  #define UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+  #define LIKELY(x) (x)
+  #define UNLIKELY(x) (x)
+#endif
+
+// HOT functions are optimized harder and grouped together; calls to COLD ones are treated as unlikely.
+#if defined(__GNUC__) || defined(__clang__)
+  #define HOT __attribute__((hot))
+  #define COLD __attribute__((cold))
+#else
+  #define HOT
+  #define COLD
+#endif
+
+// "locality" is 0 (no temporal locality, don't keep it around) to 3 (keep it in every cache level).
+// Has to be a compile-time constant.
+#if defined(__GNUC__) || defined(__clang__)
+  #define PREFETCH_READ(addr, locality) __builtin_prefetch((addr), 0, (locality))
+  #define PREFETCH_WRITE(addr, locality) __builtin_prefetch((addr), 1, (locality))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <xmmintrin.h>
+  #define PREFETCH_READ(addr, locality) _mm_prefetch(reinterpret_cast<const char*>(addr), \
+    (locality) >= 3 ? _MM_HINT_T0 : (locality) == 2 ? _MM_HINT_T1 : (locality) == 1 ? _MM_HINT_T2 : _MM_HINT_NTA)
+  #define PREFETCH_WRITE(addr, locality) PREFETCH_READ(addr, locality)
+#else
+  #define PREFETCH_READ(addr, locality) ((void)(addr))
+  #define PREFETCH_WRITE(addr, locality) ((void)(addr))
+#endif
+
+// Tells the optimizer "cond" always holds. If it doesn't, that's undefined behaviour - not an assert.
+#if defined(__clang__)
+  #define ASSUME(cond) __builtin_assume(cond)
+#elif defined(_MSC_VER)
+  #define ASSUME(cond) __assume(cond)
+#elif defined(__GNUC__)
+  #define ASSUME(cond) do { if (!(cond)) __builtin_unreachable(); } while (false)
+#else
+  #define ASSUME(cond) ((void)0)
+#endif
+
+#if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+  #define RESTRICT __restrict
+#else
+  #define RESTRICT
+#endif
+
+// 64 bytes on about everything x86 / ARM. Apple's M-series use 128 byte lines.
+#if defined(__APPLE__) && defined(__aarch64__)
+  #define SELENA_CACHELINE_SIZE 128
+#else
+  #define SELENA_CACHELINE_SIZE 64
+#endif
+#define CACHELINE_ALIGNED alignas(SELENA_CACHELINE_SIZE)
+
+// Usage: "SELENA_TRACE_SCOPE("parse_request");" - records how long the enclosing scope took.
+// Compiled out unless SELENA_TRACE is defined; see trace.hpp for the buffering and the
+// Chrome Trace / Perfetto JSON flusher. The name must be a string literal (or otherwise outlive the trace).
+#define SELENA_CONCAT_IMPL(a, b) a##b
+#define SELENA_CONCAT(a, b) SELENA_CONCAT_IMPL(a, b)
+
+#ifdef SELENA_TRACE
+  #include "trace.hpp"
+  #define SELENA_TRACE_SCOPE(name) const selena::trace::scope SELENA_CONCAT(_selena_trace_scope_, __LINE__){ name }
+#else
+  #define SELENA_TRACE_SCOPE(name) ((void)0)
+#endif
+
 #endif // SELENA_BASE_HPP
@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_CORO_HPP
+#define SELENA_CORO_HPP
+
+// C++20 coroutines on top of a minimal epoll event loop (Linux).
+// The rest of selena sticks to C++17; this header is empty unless compiled as C++20 or later.
+//   selena::task<int> job(selena::event_loop& loop) {
+//     const int status{ co_await selena::async_run_shell(loop, "make -j8") };
+//     co_return WEXITSTATUS(status);
+//   }
+//   selena::event_loop loop{};
+//   const int code{ loop.run(job(loop)) };
+// One event_loop runs on one thread, but any number of coroutines can wait on it at once - a child
+// process is a pidfd in the epoll set, not a thread. For more throughput, run one loop per thread.
+
+#if defined(__linux__) && __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+
+#include <sys/epoll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "base.hpp"
+#include "handle.hpp"
+#include "process.hpp"
+
+namespace selena {
+template<typename T = void>
+class task;
+
+namespace detail {
+struct _impl_task_promise_base {
+  // Resumes whoever co_awaited the task - symmetric transfer, so long chains don't grow the stack
+  struct final_awaiter {
+    bool await_ready() noexcept { return false; }
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(const std::coroutine_handle<Promise> h) noexcept {
+      return h.promise().continuation;
+    }
+    void await_resume() noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  final_awaiter final_suspend() noexcept { return {}; }
+
+  std::coroutine_handle<> continuation{ std::noop_coroutine() };
+};
+
+template<typename T>
+struct _impl_task_promise : _impl_task_promise_base {
+  task<T> get_return_object() noexcept;
+
+  template<typename U>
+  void return_value(U&& value) { result.template emplace<1>(std::forward<U>(value)); }
+  void unhandled_exception() noexcept { result.template emplace<2>(std::current_exception()); }
+
+  T take() {
+    if (result.index() == 2) std::rethrow_exception(std::get<2>(result));
+    return std::move(std::get<1>(result));
+  }
+
+  std::variant<std::monostate, T, std::exception_ptr> result{};
+};
+
+template<>
+struct _impl_task_promise<void> : _impl_task_promise_base {
+  task<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+  void unhandled_exception() noexcept { error = std::current_exception(); }
+
+  void take() {
+    if (error) std::rethrow_exception(error);
+  }
+
+  std::exception_ptr error{};
+};
+} // namespace detail
+
+/*
+ * A lazily started coroutine producing a T. Starts running when co_awaited (or handed to
+ * event_loop::run() / spawn()), and resumes its awaiter when it finishes. Move-only.
+ */
+template<typename T>
+class [[nodiscard]] task {
+public:
+  using promise_type = detail::_impl_task_promise<T>;
+  using handle_type = std::coroutine_handle<promise_type>;
+
+  task() noexcept = default;
+  explicit task(const handle_type handle) noexcept : _handle{ handle } {}
+  task(task&& other) noexcept : _handle{ std::exchange(other._handle, {}) } {}
+  task& operator=(task&& other) noexcept {
+    if (this != &other) {
+      if (_handle) _handle.destroy();
+      _handle = std::exchange(other._handle, {});
+    }
+    return *this;
+  }
+  ~task() {
+    if (_handle) _handle.destroy();
+  }
+
+  NO_COPY(task)
+
+  [[nodiscard]] bool done() const noexcept { return !_handle || _handle.done(); }
+
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      handle_type handle;
+      bool await_ready() const noexcept { return !handle || handle.done(); }
+      std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() { return handle.promise().take(); }
+    };
+    return awaiter{ _handle };
+  }
+
+private:
+  handle_type _handle{};
+}; // class task
+
+template<typename T>
+task<T> detail::_impl_task_promise<T>::get_return_object() noexcept {
+  return task<T>{ std::coroutine_handle<_impl_task_promise<T>>::from_promise(*this) };
+}
+
+inline task<void> detail::_impl_task_promise<void>::get_return_object() noexcept {
+  return task<void>{ std::coroutine_handle<_impl_task_promise<void>>::from_promise(*this) };
+}
+
+class event_loop;
+
+namespace detail {
+// What an epoll event points to: lives in the suspended awaiter, i.e. in the coroutine frame
+struct _impl_waiter {
+  int fd{ -1 };
+  std::coroutine_handle<> handle{};
+};
+} // namespace detail
+
+/*
+ * co_await-able readiness of a file descriptor. Obtained from event_loop::readable() / writable().
+ * co_await yields 0 once the fd is ready, or an errno value if it couldn't be watched.
+ */
+class fd_awaitable {
+public:
+  fd_awaitable(event_loop& loop, const int fd, const uint32_t events) : _loop{ loop }, _events{ events } {
+    _waiter.fd = fd;
+  }
+
+  bool await_ready() const noexcept { return false; }
+  inline bool await_suspend(std::coroutine_handle<> awaiting) noexcept;
+  int await_resume() const noexcept { return _error; }
+
+private:
+  event_loop& _loop;
+  uint32_t _events;
+  detail::_impl_waiter _waiter{};
+  int _error{ 0 };
+}; // class fd_awaitable
+
+class event_loop {
+public:
+  event_loop() : _epoll{ ::epoll_create1(EPOLL_CLOEXEC) } {}
+
+  // Coroutines still suspended on it are destroyed; child processes they were waiting for are killed
+  ~event_loop() {
+    while (_detached) std::coroutine_handle<_impl_detached::promise_type>::from_promise(*_detached).destroy();
+  }
+
+  // Awaiters hold on to it
+  NO_COPY_MOVE(event_loop)
+
+  // false if the epoll instance couldn't be created
+  [[nodiscard]] bool ok() const noexcept { return static_cast<bool>(_epoll); }
+
+  // @returns fd_awaitable co_await it to suspend until "fd" is readable
+  [[nodiscard]] fd_awaitable readable(const int fd) { return { *this, fd, EPOLLIN }; }
+
+  // @returns fd_awaitable co_await it to suspend until "fd" is writable
+  [[nodiscard]] fd_awaitable writable(const int fd) { return { *this, fd, EPOLLOUT }; }
+
+  /*
+   * Starts "t" on this loop without waiting for it. The loop keeps it alive until it finishes.
+   * If it throws, the exception is rethrown from run().
+   * @param t Must run on this loop, i.e. only co_await things from this loop
+   */
+  void spawn(task<void> t) {
+    _impl_detached d{ _impl_drive(*this, std::move(t)) };
+    _impl_detached::promise_type& promise{ d.handle.promise() };
+    promise.loop = this;
+    promise.next = _detached;
+    if (_detached) _detached->prev = &promise;
+    _detached = &promise;
+    _ready.push_back(d.handle);
+  }
+
+  /*
+   * Runs until every spawned task finished and nothing is waited on any more.
+   * Rethrows the first exception a spawned task let escape (the rest of them keep running on the next run()).
+   */
+  void run() {
+    epoll_event events[64];
+    for (;;) {
+      while (!_ready.empty()) {
+        const std::coroutine_handle<> h{ _ready.front() };
+        _ready.pop_front();
+        h.resume();
+        if (_error) std::rethrow_exception(std::exchange(_error, nullptr));
+      }
+      if (!_waiting) return;
+
+      const int n{ ::epoll_wait(_epoll.get(), events, 64, -1) };
+      if (n == -1) {
+        if (errno == EINTR) continue;
+        return; // Can't happen with a valid epoll fd, but don't spin if it does
+      }
+      for (int i{ 0 }; i < n; ++i) {
+        const detail::_impl_waiter& waiter{ *static_cast<detail::_impl_waiter*>(events[i].data.ptr) };
+        ::epoll_ctl(_epoll.get(), EPOLL_CTL_DEL, waiter.fd, nullptr);
+        --_waiting;
+        _ready.push_back(waiter.handle);
+      }
+    }
+  }
+
+  /*
+   * Runs "t" to completion, along with everything else on the loop, and returns its result.
+   * @param t The task
+   * @returns T Whatever "t" co_returns. Its exception, if any, is rethrown.
+   */
+  template<typename T>
+  T run(task<T> t) {
+    // Shared with the wrapper: if another task's exception ends run() first, "t" is left behind
+    // on the loop and still has somewhere to put its result
+    const std::shared_ptr<_impl_captured<T>> captured{ std::make_shared<_impl_captured<T>>() };
+    spawn(_impl_capture(std::move(t), captured));
+    run();
+    if (captured->error) std::rethrow_exception(captured->error);
+    if constexpr (!std::is_void_v<T>) return std::move(*captured->result);
+  }
+
+private:
+  friend class fd_awaitable;
+  friend class process_awaitable;
+
+  // Self-destroying wrapper around a spawned task. The loop links the promises of those still
+  // running into a list, which each one leaves as it's destroyed - finished or not, in O(1).
+  struct _impl_detached {
+    struct promise_type {
+      event_loop* loop{ nullptr };
+      promise_type* prev{ nullptr };
+      promise_type* next{ nullptr };
+
+      ~promise_type() {
+        if (!loop) return;
+        (prev ? prev->next : loop->_detached) = next;
+        if (next) next->prev = prev;
+      }
+
+      _impl_detached get_return_object() noexcept {
+        return { std::coroutine_handle<promise_type>::from_promise(*this) };
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept { std::terminate(); } // _impl_drive() catches everything
+    };
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  static _impl_detached _impl_drive(event_loop& loop, task<void> t) {
+    try {
+      co_await std::move(t);
+    } catch (...) {
+      if (!loop._error) loop._error = std::current_exception();
+    }
+    // Destroys itself from here (final_suspend never suspends), leaving loop._detached
+  }
+
+  template<typename T>
+  struct _impl_captured {
+    std::optional<std::conditional_t<std::is_void_v<T>, char, T>> result{};
+    std::exception_ptr error{};
+  };
+
+  template<typename T>
+  static task<void> _impl_capture(task<T> t, const std::shared_ptr<_impl_captured<T>> captured) {
+    try {
+      if constexpr (std::is_void_v<T>) {
+        co_await std::move(t);
+        captured->result.emplace();
+      } else {
+        captured->result.emplace(co_await std::move(t));
+      }
+    } catch (...) {
+      captured->error = std::current_exception();
+    }
+  }
+
+  // One-shot: run() takes the fd out of the set again as soon as it fires
+  int _impl_watch(detail::_impl_waiter& waiter, const uint32_t events) {
+    epoll_event ev{};
+    ev.events = events | EPOLLONESHOT;
+    ev.data.ptr = &waiter;
+    if (::epoll_ctl(_epoll.get(), EPOLL_CTL_ADD, waiter.fd, &ev) == -1) return errno;
+    ++_waiting;
+    return 0;
+  }
+
+  unique_fd _epoll;
+  std::deque<std::coroutine_handle<>> _ready{};
+  _impl_detached::promise_type* _detached{ nullptr }; // Spawned, not finished
+  size_t _waiting{ 0 };                              // fds in the epoll set
+  std::exception_ptr _error{};
+}; // class event_loop
+
+inline bool fd_awaitable::await_suspend(const std::coroutine_handle<> awaiting) noexcept {
+  _waiter.handle = awaiting;
+  _error = _loop._impl_watch(_waiter, _events);
+  return !_error; // Couldn't watch it: resume right away with the error
+}
+
+/*
+ * co_await-able completion of a child process, see async_run(). co_await yields the wait status,
+ * the same as selena::run(). If it's never awaited, the child is killed and reaped.
+ */
+class process_awaitable {
+public:
+  // Spawning failed: co_await yields "status" right away
+  explicit process_awaitable(const int status) : _status{ status }, _reaped{ true } {}
+
+  process_awaitable(event_loop& loop, const pid_t pid) : _loop{ &loop }, _pid{ pid } {
+    _pidfd.reset(detail::_impl_pidfd_open(pid));
+    _waiter.fd = _pidfd.get();
+  }
+
+  ~process_awaitable() {
+    if (_reaped) return;
+    ::kill(_pid, SIGKILL);
+    detail::_impl_waitpid(_pid);
+  }
+
+  // The epoll event points into it while it's awaited
+  NO_COPY_MOVE(process_awaitable)
+
+  [[nodiscard]] pid_t pid() const noexcept { return _pid; }
+
+  // Without a pidfd (kernels before 5.3), await_resume() simply blocks in waitpid()
+  bool await_ready() const noexcept { return _reaped || !_pidfd; }
+
+  bool await_suspend(const std::coroutine_handle<> awaiting) noexcept {
+    _waiter.handle = awaiting;
+    return !_loop->_impl_watch(_waiter, EPOLLIN); // Falls back to waitpid() if it can't be watched
+  }
+
+  int await_resume() {
+    if (!_reaped) {
+      _status = detail::_impl_waitpid(_pid); // Already exited if the pidfd fired, so this doesn't block
+      _reaped = true;
+    }
+    return _status;
+  }
+
+private:
+  event_loop* _loop{ nullptr };
+  pid_t _pid{ -1 };
+  unique_fd _pidfd{};
+  detail::_impl_waiter _waiter{};
+  int _status{ -1 };
+  bool _reaped{ false };
+}; // class process_awaitable
+
+/*
+ * Starts a program right away; co_await the result for its wait status. Usage:
+ * "const int status{ co_await selena::async_run(loop, argv) };"
+ * @param loop The event_loop the awaiting coroutine runs on
+ * @param argv A nullptr-terminated argument vector, argv[0] being the program. Only used during this call.
+ * @param opts See selena::spawn_options
+ * @returns process_awaitable Yields the same as selena::run() would return
+ */
+[[nodiscard]] inline process_awaitable async_run(event_loop& loop, const char* const* const argv,
+  const spawn_options& opts = {}) {
+  pid_t pid{ 0 };
+  if (const int err{ spawn(argv, pid, opts) }; err)
+    return process_awaitable{ (err == ENOENT || err == EACCES || err == ENOEXEC) ? (127 << 8) : -1 };
+  return process_awaitable{ loop, pid };
+}
+
+/*
+ * Same as async_run(), for a shell command line - the awaitable counterpart of selena::run_shell()
+ * (and so of selena::system() / system_suppressed(), with opts.suppressed).
+ * @param loop The event_loop the awaiting coroutine runs on
+ * @param cmd A C-style string which specifies the command. Only used during this call.
+ * @param opts See selena::spawn_options
+ * @returns process_awaitable Yields the same as selena::run_shell() would return
+ */
+[[nodiscard]] inline process_awaitable async_run_shell(event_loop& loop, const char* const cmd,
+  const spawn_options& opts = {}) {
+  if (!cmd) return process_awaitable{ 1 };
+  pid_t pid{ 0 };
+  if (const int err{ spawn_shell(cmd, pid, opts) }; err) return process_awaitable{ -1 };
+  return process_awaitable{ loop, pid };
+}
+} // namespace selena
+
+#endif // __linux__ && C++20
+
+#endif // SELENA_CORO_HPP
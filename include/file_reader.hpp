@@ -0,0 +1,463 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_FILE_READER_HPP
+#define SELENA_FILE_READER_HPP
+
+// Sequential whole-file reader for bulk jobs - URL / token lists fed to is_valid_url() and friends.
+// On Linux, it keeps "queue_depth" reads of "block_size" bytes in flight through io_uring, into
+// buffers registered with the kernel once, so the next blocks are already on their way while the
+// current one is being validated. Blocks are still handed out in file order.
+// Where io_uring isn't available (kernels before 5.1, kernel.io_uring_disabled, seccomp'ed
+// containers, other POSIX systems), the same blocks are read with plain blocking pread()s.
+// There's no liburing dependency: the three syscalls are issued directly.
+
+// Only POSIX has pread()
+#ifndef _WIN32
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <new>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #define SELENA_HAS_IO_URING 1
+#else
+  #define SELENA_HAS_IO_URING 0
+#endif
+
+#include "base.hpp"
+#include "handle.hpp"
+#include "utils.hpp"
+
+namespace selena {
+struct file_reader_options {
+  // Bytes per read, i.e. per block handed to the callback. At least a page.
+  size_t block_size{ size_t{ 1 } << 20 };
+  // Reads kept in flight, each with a buffer of its own. io_uring only; pread() has one at a time.
+  size_t queue_depth{ 4 };
+  // false forces the pread() path
+  bool use_io_uring{ true };
+};
+
+// What the count_valid_*() helpers report
+struct line_stats {
+  size_t lines{ 0 };
+  size_t valid{ 0 };
+  int error{ 0 }; // errno value, 0 on success
+};
+
+namespace detail {
+#if SELENA_HAS_IO_URING
+// The bare minimum of a ring: set up, queue reads, submit, reap. Single-threaded use only.
+class _impl_uring {
+public:
+  explicit _impl_uring(const unsigned entries) {
+    io_uring_params params{};
+    _fd.reset(static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params)));
+    if (!_fd) return;
+
+    size_t sq_size{ params.sq_off.array + params.sq_entries * sizeof(unsigned) };
+    size_t cq_size{ params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe) };
+    const bool single_mmap{ (params.features & IORING_FEAT_SINGLE_MMAP) != 0 }; // 5.4+
+    if (single_mmap) sq_size = cq_size = std::max(sq_size, cq_size);
+
+    if (!_sq.map(_fd.get(), sq_size, IORING_OFF_SQ_RING) ||
+        !_sqes.map(_fd.get(), params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES) ||
+        (!single_mmap && !_cq.map(_fd.get(), cq_size, IORING_OFF_CQ_RING))) {
+      _fd.reset();
+      return;
+    }
+    std::byte* const sq{ static_cast<std::byte*>(_sq.ptr) };
+    std::byte* const cq{ static_cast<std::byte*>(single_mmap ? _sq.ptr : _cq.ptr) };
+    _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  }
+
+  // The mappings point into the kernel's ring
+  NO_COPY_MOVE(_impl_uring)
+
+  explicit operator bool() const noexcept { return static_cast<bool>(_fd); }
+
+  // Pins the pages once, instead of on every read. Can fail against RLIMIT_MEMLOCK on older kernels.
+  bool register_buffers(const iovec* const iov, const unsigned count) {
+    return ::syscall(__NR_io_uring_register, _fd.get(), IORING_REGISTER_BUFFERS, iov, count) == 0;
+  }
+
+  // Queues a READ_FIXED from registered buffer "buf_index" if it's >= 0, a READV of "*iov" otherwise.
+  // The caller never has more reads queued than the ring has entries.
+  void queue_read(const int fd, const iovec* const iov, const int buf_index, const uint64_t offset,
+    const uint64_t user_data) {
+    const unsigned tail{ *_sq_tail };
+    const unsigned index{ tail & _sq_mask };
+    io_uring_sqe& sqe{ static_cast<io_uring_sqe*>(_sqes.ptr)[index] };
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.fd = fd;
+    sqe.off = offset;
+    sqe.user_data = user_data;
+    if (buf_index >= 0) {
+      sqe.opcode = IORING_OP_READ_FIXED;
+      sqe.addr = reinterpret_cast<uint64_t>(iov->iov_base);
+      sqe.len = static_cast<uint32_t>(iov->iov_len);
+      sqe.buf_index = static_cast<uint16_t>(buf_index);
+    } else {
+      sqe.opcode = IORING_OP_READV;
+      sqe.addr = reinterpret_cast<uint64_t>(iov);
+      sqe.len = 1;
+    }
+    _sq_array[index] = index;
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE); // The kernel reads the SQE after seeing the tail
+    ++_unsubmitted;
+  }
+
+  // Submits whatever was queued and waits for at least "wait_nr" completions. 0 or an errno value.
+  int submit_and_wait(const unsigned wait_nr) {
+    for (;;) {
+      const long submitted{ ::syscall(__NR_io_uring_enter, _fd.get(), _unsubmitted, wait_nr, IORING_ENTER_GETEVENTS,
+        nullptr, 0) };
+      if (submitted >= 0) {
+        _unsubmitted -= static_cast<unsigned>(submitted);
+        return 0;
+      }
+      if (errno != EINTR) return errno;
+    }
+  }
+
+  // Calls fn(user_data, res) for every completion available right now
+  template<typename F>
+  void reap(F&& fn) {
+    unsigned head{ *_cq_head };
+    const unsigned tail{ __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE) };
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe{ _cqes[head & _cq_mask] };
+      fn(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE); // Hands the CQEs back to the kernel
+  }
+
+private:
+  struct _impl_mapping {
+    void* ptr{ nullptr };
+    size_t size{ 0 };
+
+    _impl_mapping() = default;
+    ~_impl_mapping() {
+      if (ptr) ::munmap(ptr, size);
+    }
+    NO_COPY_MOVE(_impl_mapping)
+
+    bool map(const int fd, const size_t bytes, const off_t offset) {
+      void* const p{ ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset) };
+      if (p == MAP_FAILED) return false;
+      ptr = p;
+      size = bytes;
+      return true;
+    }
+  };
+
+  // Unmapped before the fd is closed
+  unique_fd _fd{};
+  _impl_mapping _sq{};
+  _impl_mapping _cq{};
+  _impl_mapping _sqes{};
+  unsigned* _sq_tail{ nullptr };
+  unsigned* _sq_array{ nullptr };
+  unsigned _sq_mask{ 0 };
+  unsigned* _cq_head{ nullptr };
+  unsigned* _cq_tail{ nullptr };
+  unsigned _cq_mask{ 0 };
+  io_uring_cqe* _cqes{ nullptr };
+  unsigned _unsubmitted{ 0 };
+}; // class _impl_uring
+#endif // SELENA_HAS_IO_URING
+
+struct _impl_page_delete {
+  void operator()(std::byte* const p) const noexcept { ::operator delete(p, std::align_val_t{ 4096 }); }
+};
+} // namespace detail
+
+/*
+ * Reads whole files block by block. Usage:
+ *   selena::file_reader reader{};
+ *   const selena::line_stats stats{ selena::count_valid_urls(reader, "urls.txt") };
+ * or, for anything else, reader.for_each_line(path, [](std::string_view line) { ... }).
+ * One reader is meant to be reused for many files: the ring and the buffers are set up once.
+ * Not thread-safe - use one reader per thread.
+ */
+class file_reader {
+public:
+  explicit file_reader(const file_reader_options& opts = {}) :
+    _block{ (std::max(opts.block_size, size_t{ 4096 }) + 4095) & ~size_t{ 4095 } },
+    _depth{ std::clamp(opts.queue_depth, size_t{ 1 }, size_t{ 64 }) } {
+#if SELENA_HAS_IO_URING
+    if (opts.use_io_uring) {
+      _ring = std::make_unique<detail::_impl_uring>(static_cast<unsigned>(_depth));
+      if (!*_ring) _ring.reset();
+    }
+#endif // SELENA_HAS_IO_URING
+    if (!uses_io_uring()) _depth = 1; // pread() only ever uses one buffer
+    _buffers.reset(static_cast<std::byte*>(::operator new(_block * _depth, std::align_val_t{ 4096 })));
+    _slots.resize(_depth);
+    for (size_t i{ 0 }; i < _depth; ++i) _slots[i].iov = { _buffers.get() + i * _block, _block };
+#if SELENA_HAS_IO_URING
+    if (_ring) {
+      std::vector<iovec> iov(_depth);
+      for (size_t i{ 0 }; i < _depth; ++i) iov[i] = _slots[i].iov;
+      _fixed = _ring->register_buffers(iov.data(), static_cast<unsigned>(_depth));
+    }
+#endif // SELENA_HAS_IO_URING
+  }
+
+  // In-flight reads point into the buffers
+  NO_COPY_MOVE(file_reader)
+
+  // false if reads go through pread()
+  [[nodiscard]] bool uses_io_uring() const noexcept {
+#if SELENA_HAS_IO_URING
+    return static_cast<bool>(_ring);
+#else
+    return false;
+#endif // SELENA_HAS_IO_URING
+  }
+
+  [[nodiscard]] size_t block_size() const noexcept { return _block; }
+
+  /*
+   * Reads the whole file, in order.
+   * @param path The file. Pipes and other non-seekable files work too, through plain read()s.
+   * @param on_block Called as on_block(std::string_view) for every block, in file order. The view is
+   * only valid during the call. If it throws, the reads still in flight are waited for, then it's rethrown.
+   * @returns int 0 on success, an errno value otherwise. Blocks before the error were already handed out.
+   */
+  template<typename F>
+  int read(const char* const path, F&& on_block) {
+    const unique_fd fd{ ::open(path, O_RDONLY | O_CLOEXEC) };
+    if (!fd) return errno;
+    struct stat st{};
+    if (::fstat(fd.get(), &st) == -1) return errno;
+    const bool regular{ S_ISREG(st.st_mode) };
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (regular) ::posix_fadvise(fd.get(), 0, 0, POSIX_FADV_SEQUENTIAL); // Bigger readahead
+#endif // POSIX_FADV_SEQUENTIAL
+#if SELENA_HAS_IO_URING
+    if (_ring && regular) return _impl_read_ring(fd.get(), static_cast<uint64_t>(st.st_size), on_block);
+#endif // SELENA_HAS_IO_URING
+    return _impl_read_blocking(fd.get(), regular, on_block);
+  }
+
+  /*
+   * Reads the whole file and splits it into lines. A trailing '\r' is dropped, so are the '\n's.
+   * @param path The file
+   * @param on_line Called as on_line(std::string_view) for every line. Only valid during the call.
+   * Lines are views into the read buffers, except for those crossing a block boundary.
+   * @returns int 0 on success, an errno value otherwise
+   */
+  template<typename F>
+  int for_each_line(const char* const path, F&& on_line) {
+    std::string carry{}; // Start of a line which continues in the next block
+    const auto emit = [&](std::string_view line) {
+      if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+      on_line(line);
+    };
+    const int err{ read(path, [&](std::string_view block) {
+      while (!block.empty()) {
+        const void* const nl{ std::memchr(block.data(), '\n', block.size()) };
+        if (!nl) {
+          carry.append(block);
+          return;
+        }
+        const size_t len{ static_cast<size_t>(static_cast<const char*>(nl) - block.data()) };
+        if (carry.empty()) {
+          emit(block.substr(0, len));
+        } else {
+          carry.append(block.data(), len);
+          emit(carry);
+          carry.clear();
+        }
+        block.remove_prefix(len + 1);
+      }
+    }) };
+    if (!err && !carry.empty()) emit(carry); // Last line without a '\n'
+    return err;
+  }
+
+private:
+  struct _impl_slot {
+    iovec iov{};        // Whole buffer
+    iovec pending{};    // What's still to be read into it
+    uint64_t offset{ 0 };
+    size_t length{ 0 }; // Block size, smaller for the last one
+    size_t got{ 0 };
+    bool done{ false };
+  };
+
+  template<typename F>
+  int _impl_read_blocking(const int fd, const bool seekable, F& on_block) {
+    std::byte* const buf{ _buffers.get() };
+    for (uint64_t offset{ 0 };;) {
+      const ssize_t n{ seekable ? ::pread(fd, buf, _block, static_cast<off_t>(offset)) : ::read(fd, buf, _block) };
+      if (n == -1) {
+        if (errno == EINTR) continue;
+        return errno;
+      }
+      if (!n) return 0;
+      on_block(std::string_view{ reinterpret_cast<const char*>(buf), static_cast<size_t>(n) });
+      offset += static_cast<uint64_t>(n);
+    }
+  }
+
+#if SELENA_HAS_IO_URING
+  // Block k always goes to slot k % depth, so slots complete in any order but are handed out in turn
+  template<typename F>
+  int _impl_read_ring(const int fd, uint64_t size, F& on_block) {
+    uint64_t next_offset{ 0 };
+    size_t in_flight{ 0 };
+    int error{ 0 };
+
+    const auto queue = [&](const size_t s) {
+      _impl_slot& slot{ _slots[s] };
+      slot.pending = { static_cast<std::byte*>(slot.iov.iov_base) + slot.got, slot.length - slot.got };
+      _ring->queue_read(fd, &slot.pending, _fixed ? static_cast<int>(s) : -1, slot.offset + slot.got, s);
+      ++in_flight;
+    };
+    const auto start_next = [&](const size_t s) {
+      if (next_offset >= size) return;
+      _impl_slot& slot{ _slots[s] };
+      slot.offset = next_offset;
+      slot.length = static_cast<size_t>(std::min<uint64_t>(_block, size - next_offset));
+      slot.got = 0;
+      slot.done = false;
+      next_offset += slot.length;
+      queue(s);
+    };
+    // Nothing may be left pointing into the buffers when returning
+    const auto drain = [&] {
+      while (in_flight) {
+        if (_ring->submit_and_wait(1)) return; // Can't happen with a valid ring
+        _ring->reap([&](uint64_t, int) { --in_flight; });
+      }
+    };
+
+    for (size_t s{ 0 }; s < _depth; ++s) start_next(s);
+    size_t turn{ 0 };
+    uint64_t handed_out{ 0 };
+    try {
+      while (handed_out < size && !error) {
+        if ((error = _ring->submit_and_wait(1))) break;
+        _ring->reap([&](const uint64_t s, const int res) {
+          --in_flight;
+          _impl_slot& slot{ _slots[s] };
+          if (res == -EINTR || res == -EAGAIN) return queue(s);
+          if (res < 0) {
+            if (!error) error = -res;
+            return;
+          }
+          slot.got += static_cast<size_t>(res);
+          if (!res) {
+            // The file got shorter since fstat(): it ends here
+            size = std::min<uint64_t>(size, slot.offset + slot.got);
+            slot.length = slot.got;
+          }
+          if (slot.got < slot.length) return queue(s); // Short read
+          slot.done = true;
+        });
+        for (; !error && handed_out < size && _slots[turn].done; turn = (turn + 1) % _depth) {
+          _impl_slot& slot{ _slots[turn] };
+          slot.done = false;
+          if (slot.length)
+            on_block(std::string_view{ static_cast<const char*>(slot.iov.iov_base), slot.length });
+          handed_out += slot.length;
+          start_next(turn);
+        }
+      }
+    } catch (...) {
+      drain();
+      throw;
+    }
+    drain();
+    return error;
+  }
+#endif // SELENA_HAS_IO_URING
+
+  size_t _block;
+  size_t _depth;
+#if SELENA_HAS_IO_URING
+  std::unique_ptr<detail::_impl_uring> _ring{};
+  bool _fixed{ false }; // Buffers registered with the ring
+#endif // SELENA_HAS_IO_URING
+  std::unique_ptr<std::byte, detail::_impl_page_delete> _buffers{};
+  std::vector<_impl_slot> _slots{};
+}; // class file_reader
+
+/*
+ * Runs selena::is_valid_url() on every line of a file.
+ * @param reader The file_reader to read with
+ * @param path One URL per line
+ * @returns line_stats Number of lines, of valid ones, and an errno value if reading failed
+ */
+[[nodiscard]] inline line_stats count_valid_urls(file_reader& reader, const char* const path) {
+  line_stats stats{};
+  stats.error = reader.for_each_line(path, [&](const std::string_view line) {
+    ++stats.lines;
+    stats.valid += is_valid_url(line);
+  });
+  return stats;
+}
+
+/*
+ * Runs selena::is_valid_format() on every line of a file.
+ * @param reader The file_reader to read with
+ * @param path One input per line
+ * @param re_pattern A regex object
+ * @returns line_stats Number of lines, of matching ones, and an errno value if reading failed
+ */
+[[nodiscard]] inline line_stats count_valid_format(file_reader& reader, const char* const path,
+  const std::regex& re_pattern) {
+  line_stats stats{};
+  stats.error = reader.for_each_line(path, [&](const std::string_view line) {
+    ++stats.lines;
+    stats.valid += is_valid_format(line, re_pattern);
+  });
+  return stats;
+}
+} // namespace selena
+
+#endif // _WIN32
+
+#endif // SELENA_FILE_READER_HPP
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_HANDLE_HPP
+#define SELENA_HANDLE_HPP
+
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+
+#ifndef _WIN32
+  #include <unistd.h>
+#endif // _WIN32
+
+#include "base.hpp"
+
+namespace selena {
+namespace detail {
+// Empty base optimization: a stateless deleter takes no space. Function pointers and final
+// classes can't be inherited from, so those are stored as a plain member instead.
+template<typename Deleter, bool = std::is_empty_v<Deleter> && !std::is_final_v<Deleter>>
+class _impl_deleter_storage : private Deleter {
+protected:
+  _impl_deleter_storage() = default;
+  explicit _impl_deleter_storage(Deleter d) : Deleter(std::move(d)) {}
+  Deleter& _get() noexcept { return *this; }
+  const Deleter& _get() const noexcept { return *this; }
+};
+
+template<typename Deleter>
+class _impl_deleter_storage<Deleter, false> {
+protected:
+  _impl_deleter_storage() = default;
+  explicit _impl_deleter_storage(Deleter d) : _deleter{ std::move(d) } {}
+  Deleter& _get() noexcept { return _deleter; }
+  const Deleter& _get() const noexcept { return _deleter; }
+
+private:
+  Deleter _deleter{};
+};
+} // namespace detail
+
+/*
+ * std::unique_ptr for things which aren't pointers (or aren't "new"ed): file descriptors,
+ * FILE*, handles from C libraries... Move-only, and with a stateless deleter it's exactly
+ * as big as the raw handle - no heap allocation, no extra word.
+ * Usage: "unique_handle<int, fd_deleter, -1> fd{ ::open(...) };" - or simply "unique_fd".
+ * @tparam T The raw handle type
+ * @tparam Deleter Called with the handle when it's released. Never called with "Null".
+ * @tparam Null The "no handle" value, ex. -1 for fds, nullptr for pointers
+ */
+template<typename T, typename Deleter, T Null = T{}>
+class unique_handle : private detail::_impl_deleter_storage<Deleter> {
+  using storage = detail::_impl_deleter_storage<Deleter>;
+
+public:
+  using handle_type = T;
+  using deleter_type = Deleter;
+
+  constexpr unique_handle() noexcept = default;
+  explicit unique_handle(const T handle) noexcept : _handle{ handle } {}
+  unique_handle(const T handle, Deleter deleter) : storage(std::move(deleter)), _handle{ handle } {}
+
+  unique_handle(unique_handle&& other) noexcept : storage(std::move(other._get())), _handle{ other.release() } {}
+
+  unique_handle& operator=(unique_handle&& other) noexcept {
+    if (this != &other) {
+      reset(other.release());
+      this->_get() = std::move(other._get());
+    }
+    return *this;
+  }
+
+  ~unique_handle() { reset(); }
+
+  NO_COPY(unique_handle)
+
+  [[nodiscard]] T get() const noexcept { return _handle; }
+  [[nodiscard]] explicit operator bool() const noexcept { return _handle != Null; }
+  [[nodiscard]] static constexpr T null() noexcept { return Null; }
+
+  Deleter& get_deleter() noexcept { return this->_get(); }
+  const Deleter& get_deleter() const noexcept { return this->_get(); }
+
+  // Gives up ownership without closing anything
+  [[nodiscard]] T release() noexcept { return std::exchange(_handle, Null); }
+
+  // Closes the current handle (if any) and takes ownership of "handle"
+  void reset(const T handle = Null) noexcept {
+    const T old{ std::exchange(_handle, handle) };
+    if (old != Null) this->_get()(old);
+  }
+
+  void swap(unique_handle& other) noexcept {
+    using std::swap;
+    swap(_handle, other._handle);
+    swap(this->_get(), other._get());
+  }
+
+  friend void swap(unique_handle& a, unique_handle& b) noexcept { a.swap(b); }
+
+private:
+  T _handle{ Null };
+}; // class unique_handle
+
+// Turns a C function into a stateless deleter. Usage: "unique_handle<sqlite3*, fn_deleter<&sqlite3_close>>"
+template<auto Fn>
+struct fn_deleter {
+  template<typename T>
+  void operator()(const T handle) const noexcept { Fn(handle); }
+};
+
+struct file_deleter {
+  void operator()(std::FILE* const file) const noexcept { std::fclose(file); }
+};
+using unique_file = unique_handle<std::FILE*, file_deleter, nullptr>;
+static_assert(sizeof(unique_file) == sizeof(std::FILE*));
+
+#ifndef _WIN32
+struct fd_deleter {
+  void operator()(const int fd) const noexcept { ::close(fd); }
+};
+using unique_fd = unique_handle<int, fd_deleter, -1>;
+static_assert(sizeof(unique_fd) == sizeof(int));
+#endif // _WIN32
+} // namespace selena
+
+#endif // SELENA_HANDLE_HPP
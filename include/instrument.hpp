@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_INSTRUMENT_HPP
+#define SELENA_INSTRUMENT_HPP
+
+// Opt-in counters and latency histograms for selena's own functions.
+// Compiled out unless SELENA_INSTRUMENT is defined (for the whole program - it changes what the
+// other headers expand to). When it is, every thread gets its own block of counters / histograms,
+// which only that thread writes to, so the hot path is a few relaxed atomic stores and no locking.
+// Readers (take_snapshot()) sum all threads' blocks, plus whatever exited threads left behind.
+
+#ifdef SELENA_INSTRUMENT
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "base.hpp"
+
+namespace selena::instrument {
+enum class counter : size_t {
+  regex_compiles,     // is_valid_format(string, string) building a std::regex
+  trng_entropy_reads, // random_trng pulling from std::random_device
+  spawns,             // Children started by the process launcher
+  forked_spawns,      // ... of which went through fork() (resource limits)
+  shell_spawns,       // ... of which needed /bin/sh
+  _count
+};
+
+enum class timer : size_t {
+  is_valid_format,
+  is_valid_url,
+  getenv,
+  iequal_str,
+  icontains,
+  system,
+  system_suppressed,
+  prng_random,
+  trng_random,
+  run,
+  run_shell,
+  run_measured,
+  run_all,
+  _count
+};
+
+inline constexpr size_t counter_count{ static_cast<size_t>(counter::_count) };
+inline constexpr size_t timer_count{ static_cast<size_t>(timer::_count) };
+
+inline constexpr const char* counter_names[counter_count]{
+  "regex_compiles", "trng_entropy_reads", "spawns", "forked_spawns", "shell_spawns"
+};
+
+inline constexpr const char* timer_names[timer_count]{
+  "is_valid_format", "is_valid_url", "getenv", "iequal_str", "icontains", "system", "system_suppressed",
+  "prng_random", "trng_random", "run", "run_shell", "run_measured", "run_all"
+};
+
+// HDR-style log-linear buckets over nanoseconds: 4 sub-buckets per power of two, i.e. at most
+// 25% relative error. Values below 4 ns get exact buckets; everything past 2^47 ns (~39 hours)
+// lands in the last one.
+inline constexpr size_t sub_buckets{ 4 };
+inline constexpr size_t max_exponent{ 47 };
+inline constexpr size_t bucket_count{ sub_buckets * max_exponent };
+
+inline size_t bucket_index(const uint64_t ns) {
+  if (ns < sub_buckets) return static_cast<size_t>(ns);
+#if defined(__GNUC__) || defined(__clang__)
+  const size_t msb{ 63 - static_cast<size_t>(__builtin_clzll(ns)) };
+#else
+  size_t msb{ 63 };
+  while (!(ns >> msb)) --msb;
+#endif
+  if (msb >= max_exponent + 1) return bucket_count - 1;
+  return sub_buckets * (msb - 1) + static_cast<size_t>((ns >> (msb - 2)) & (sub_buckets - 1));
+}
+
+// Smallest value which maps to the bucket
+inline uint64_t bucket_lower_bound(const size_t index) {
+  if (index < sub_buckets) return index;
+  const size_t msb{ index / sub_buckets + 1 };
+  return static_cast<uint64_t>(sub_buckets + index % sub_buckets) << (msb - 2);
+}
+
+struct histogram_snapshot {
+  uint64_t count{ 0 };
+  uint64_t sum_ns{ 0 };
+  std::array<uint64_t, bucket_count> buckets{};
+
+  /*
+   * Usage: "snap.timers[i].percentile(0.99)"
+   * @param p Between 0 and 1
+   * @returns double The bucket's lower bound the p-th value falls in, in ns. 0 if empty.
+   */
+  [[nodiscard]] double percentile(const double p) const {
+    if (!count) return 0;
+    const uint64_t rank{ static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1 };
+    uint64_t seen{ 0 };
+    for (size_t i{ 0 }; i < bucket_count; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) return static_cast<double>(bucket_lower_bound(i));
+    }
+    return static_cast<double>(bucket_lower_bound(bucket_count - 1));
+  }
+};
+
+struct snapshot {
+  std::array<uint64_t, counter_count> counters{};
+  std::array<histogram_snapshot, timer_count> timers{};
+};
+
+namespace detail {
+// Only the owning thread writes; relaxed load + store is enough and avoids a locked RMW.
+inline void _impl_bump(std::atomic<uint64_t>& value, const uint64_t n) {
+  value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+struct _impl_histogram {
+  std::atomic<uint64_t> count{ 0 };
+  std::atomic<uint64_t> sum_ns{ 0 };
+  std::atomic<uint64_t> buckets[bucket_count]{};
+};
+
+struct _impl_thread_block {
+  std::atomic<uint64_t> counters[counter_count]{};
+  _impl_histogram histograms[timer_count]{};
+};
+
+inline void _impl_accumulate(snapshot& into, const _impl_thread_block& block) {
+  for (size_t i{ 0 }; i < counter_count; ++i) into.counters[i] += block.counters[i].load(std::memory_order_relaxed);
+  for (size_t t{ 0 }; t < timer_count; ++t) {
+    const _impl_histogram& h{ block.histograms[t] };
+    histogram_snapshot& s{ into.timers[t] };
+    s.count += h.count.load(std::memory_order_relaxed);
+    s.sum_ns += h.sum_ns.load(std::memory_order_relaxed);
+    for (size_t b{ 0 }; b < bucket_count; ++b) s.buckets[b] += h.buckets[b].load(std::memory_order_relaxed);
+  }
+}
+
+struct _impl_registry {
+  std::mutex mutex{};
+  std::vector<_impl_thread_block*> live{};
+  snapshot retired{}; // Totals of threads which already exited
+};
+
+// Never destroyed, so threads exiting during static destruction can still unregister.
+inline _impl_registry& _impl_get_registry() {
+  static _impl_registry* const registry{ new _impl_registry{} };
+  return *registry;
+}
+
+class _impl_thread_handle {
+public:
+  _impl_thread_handle() : _block{ new _impl_thread_block{} } {
+    _impl_registry& registry{ _impl_get_registry() };
+    const std::lock_guard<std::mutex> lock{ registry.mutex };
+    registry.live.push_back(_block);
+  }
+
+  ~_impl_thread_handle() {
+    _impl_registry& registry{ _impl_get_registry() };
+    {
+      const std::lock_guard<std::mutex> lock{ registry.mutex };
+      _impl_accumulate(registry.retired, *_block);
+      registry.live.erase(std::remove(registry.live.begin(), registry.live.end(), _block), registry.live.end());
+    }
+    delete _block;
+  }
+
+  NO_COPY_MOVE(_impl_thread_handle)
+
+  _impl_thread_block& block() { return *_block; }
+
+private:
+  _impl_thread_block* _block;
+};
+
+inline _impl_thread_block& _impl_local_block() {
+  static thread_local _impl_thread_handle handle{};
+  return handle.block();
+}
+} // namespace detail
+
+inline void add(const counter c, const uint64_t n = 1) {
+  detail::_impl_bump(detail::_impl_local_block().counters[static_cast<size_t>(c)], n);
+}
+
+inline void record(const timer t, const uint64_t ns) {
+  detail::_impl_histogram& h{ detail::_impl_local_block().histograms[static_cast<size_t>(t)] };
+  detail::_impl_bump(h.count, 1);
+  detail::_impl_bump(h.sum_ns, ns);
+  detail::_impl_bump(h.buckets[bucket_index(ns)], 1);
+}
+
+// Records the time between construction and destruction.
+class scoped_timer {
+public:
+  explicit scoped_timer(const timer t) : _timer{ t }, _start{ std::chrono::steady_clock::now() } {}
+  ~scoped_timer() {
+    const std::chrono::nanoseconds elapsed{ std::chrono::steady_clock::now() - _start };
+    record(_timer, static_cast<uint64_t>(elapsed.count()));
+  }
+
+  NO_COPY_MOVE(scoped_timer)
+
+private:
+  timer _timer;
+  std::chrono::steady_clock::time_point _start;
+};
+
+/*
+ * Sums up every thread's counters and histograms. Values written concurrently may or may not
+ * be included, but nothing is ever torn or lost.
+ * @returns snapshot The totals since the program started
+ */
+[[nodiscard]] inline snapshot take_snapshot() {
+  detail::_impl_registry& registry{ detail::_impl_get_registry() };
+  const std::lock_guard<std::mutex> lock{ registry.mutex };
+  snapshot ret{ registry.retired };
+  for (const detail::_impl_thread_block* const block : registry.live) detail::_impl_accumulate(ret, *block);
+  return ret;
+}
+
+/*
+ * Formats a snapshot in the Prometheus text exposition format. Counters become
+ * "selena_<name>_total", timers become "selena_<name>_seconds" histograms with power-of-two buckets.
+ * @param snap A snapshot, from take_snapshot()
+ * @returns std::string The exposition text
+ */
+[[nodiscard]] inline std::string to_prometheus(const snapshot& snap) {
+  std::string out{};
+  char line[256];
+
+  for (size_t i{ 0 }; i < counter_count; ++i) {
+    std::snprintf(line, sizeof(line), "# TYPE selena_%s_total counter\nselena_%s_total %llu\n", counter_names[i],
+      counter_names[i], static_cast<unsigned long long>(snap.counters[i]));
+    out += line;
+  }
+
+  // Exported le bounds: 2^6 ns (64 ns) up to 2^40 ns (~18 minutes)
+  constexpr size_t first_exp{ 6 }, last_exp{ 40 };
+  for (size_t t{ 0 }; t < timer_count; ++t) {
+    const histogram_snapshot& h{ snap.timers[t] };
+    const char* const name{ timer_names[t] };
+    std::snprintf(line, sizeof(line), "# TYPE selena_%s_seconds histogram\n", name);
+    out += line;
+
+    uint64_t cumulative{ 0 };
+    size_t b{ 0 };
+    for (size_t e{ first_exp }; e <= last_exp; ++e) {
+      const uint64_t bound{ uint64_t{ 1 } << e };
+      // Buckets are aligned to powers of two, so every bucket below "bound" fits entirely
+      for (; b < bucket_count && bucket_lower_bound(b) < bound; ++b) cumulative += h.buckets[b];
+      std::snprintf(line, sizeof(line), "selena_%s_seconds_bucket{le=\"%.9g\"} %llu\n", name,
+        static_cast<double>(bound) / 1e9, static_cast<unsigned long long>(cumulative));
+      out += line;
+    }
+    std::snprintf(line, sizeof(line),
+      "selena_%s_seconds_bucket{le=\"+Inf\"} %llu\nselena_%s_seconds_sum %.9f\nselena_%s_seconds_count %llu\n", name,
+      static_cast<unsigned long long>(h.count), name, static_cast<double>(h.sum_ns) / 1e9, name,
+      static_cast<unsigned long long>(h.count));
+    out += line;
+  }
+  return out;
+}
+} // namespace selena::instrument
+
+#define SELENA_COUNT(name, n) selena::instrument::add(selena::instrument::counter::name, (n))
+#define SELENA_TIME(name) \
+  const selena::instrument::scoped_timer SELENA_CONCAT(_selena_timer_, __LINE__){ selena::instrument::timer::name }
+
+#else // ^^^ SELENA_INSTRUMENT || !SELENA_INSTRUMENT vvv
+
+#define SELENA_COUNT(name, n) ((void)0)
+#define SELENA_TIME(name) ((void)0)
+
+#endif // SELENA_INSTRUMENT
+
+#endif // SELENA_INSTRUMENT_HPP
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_KERNELS_HPP
+#define SELENA_KERNELS_HPP
+
+// Byte-crunching loops behind some of the utilities. They're written so that the compiler can
+// vectorize them, and nothing more - no intrinsics.
+// Header-only users get them inlined, compiled for whatever ISA their own flags allow.
+// Linking the optional "selena::kernels" CMake target (which defines SELENA_HAS_KERNELS) swaps in
+// out-of-line versions compiled for several ISAs (AVX-512BW, AVX2, baseline) and picked at load
+// time from cpuid - no -march=native required on the consumer's side.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base.hpp"
+
+namespace selena::kernels {
+inline constexpr size_t npos{ static_cast<size_t>(-1) };
+
+namespace detail {
+// ASCII-only tolower, branchless so it vectorizes
+FORCE_INLINE unsigned char _impl_lower(const unsigned char c) {
+  return static_cast<unsigned char>(c + (static_cast<unsigned char>(c - 'A') < 26u ? 0x20 : 0));
+}
+
+FORCE_INLINE bool _impl_url_reject(const unsigned char c) {
+  return (c < 0x21) | (c > 0x7e) | (c == ';') | (c == '|') | (c == '`') | (c == '$');
+}
+
+inline size_t _impl_find_url_reject(const char* const data, const size_t len) {
+  constexpr size_t block{ 64 };
+  size_t i{ 0 };
+  for (; i + block <= len; i += block) {
+    unsigned char any{ 0 };
+    for (size_t j{ 0 }; j < block; ++j) any |= _impl_url_reject(static_cast<unsigned char>(data[i + j]));
+    if (any) break;
+  }
+  for (; i < len; ++i)
+    if (_impl_url_reject(static_cast<unsigned char>(data[i]))) return i;
+  return npos;
+}
+
+FORCE_INLINE bool _impl_iequal_n(const char* const RESTRICT a, const char* const RESTRICT b, const size_t len) {
+  ASSUME(len > 0); // Only ever called with a non-empty needle
+  unsigned char diff{ 0 };
+  for (size_t i{ 0 }; i < len; ++i)
+    diff |= _impl_lower(static_cast<unsigned char>(a[i])) ^ _impl_lower(static_cast<unsigned char>(b[i]));
+  return !diff;
+}
+
+// Filters candidate positions by the needle's first and last byte a block at a time, then
+// verifies the survivors. Same idea as the usual "generic SIMD" strstr.
+inline size_t _impl_ifind(const char* const RESTRICT text, const size_t len, const char* const RESTRICT target,
+  const size_t target_len) {
+  if (UNLIKELY(!target_len)) return 0;
+  if (target_len > len) return npos;
+
+  const unsigned char first{ _impl_lower(static_cast<unsigned char>(target[0])) };
+  const unsigned char last{ _impl_lower(static_cast<unsigned char>(target[target_len - 1])) };
+  const size_t end{ len - target_len + 1 }; // Candidate positions are [0, end)
+  const char* const text_last{ text + target_len - 1 };
+
+  constexpr size_t block{ 64 };
+  size_t i{ 0 };
+  for (; i + block <= end; i += block) {
+    unsigned char hits[block];
+    unsigned char any{ 0 };
+    for (size_t j{ 0 }; j < block; ++j) {
+      hits[j] = static_cast<unsigned char>((_impl_lower(static_cast<unsigned char>(text[i + j])) == first) &
+        (_impl_lower(static_cast<unsigned char>(text_last[i + j])) == last));
+      any |= hits[j];
+    }
+    if (!any) continue;
+    for (size_t j{ 0 }; j < block; ++j)
+      if (hits[j] && _impl_iequal_n(text + i + j, target, target_len)) return i + j;
+  }
+  for (; i < end; ++i)
+    if (_impl_iequal_n(text + i, target, target_len)) return i;
+  return npos;
+}
+} // namespace detail
+
+#ifdef SELENA_HAS_KERNELS
+// Defined in src/kernels.cpp
+size_t find_url_reject(const char* data, size_t len) noexcept;
+size_t ifind(const char* text, size_t len, const char* target, size_t target_len) noexcept;
+#else // ^^^ SELENA_HAS_KERNELS || !SELENA_HAS_KERNELS vvv
+/*
+ * Finds the first byte which can't appear in an URL accepted by selena::is_valid_url():
+ * anything outside of printable ASCII (incl. space), and ';', '|', '`', '$'.
+ * @param data Pointer to the bytes
+ * @param len Number of bytes
+ * @returns size_t Index of the first such byte, or npos
+ */
+inline size_t find_url_reject(const char* const data, const size_t len) noexcept {
+  return detail::_impl_find_url_reject(data, len);
+}
+
+/*
+ * ASCII case-insensitive substring search.
+ * @param text Pointer to the text
+ * @param len Length of the text
+ * @param target Pointer to the text to search for
+ * @param target_len Length of the text to search for
+ * @returns size_t Index of the first match, 0 if target_len is 0, npos if there's no match
+ */
+inline size_t ifind(const char* const text, const size_t len, const char* const target, const size_t target_len) noexcept {
+  return detail::_impl_ifind(text, len, target, target_len);
+}
+#endif // SELENA_HAS_KERNELS
+} // namespace selena::kernels
+
+#endif // SELENA_KERNELS_HPP
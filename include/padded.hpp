@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_PADDED_HPP
+#define SELENA_PADDED_HPP
+
+// Helpers against false sharing: padded<T> gives a value a cache line (or more) of its own, and
+// per_cpu<T> spreads a value over one padded slot per CPU, so concurrent writers on different
+// cores never touch the same line. Reads combine all slots.
+
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include <cstddef>
+
+#ifdef __linux__
+  #include <sched.h>
+  #include <unistd.h>
+#endif // __linux__
+
+#include "base.hpp"
+
+namespace selena {
+// std::hardware_destructive_interference_size where it's usable. GCC has it, but its value
+// depends on -mtune and it warns (-Winterference-size) about using it in headers. The check is on
+// __GNUC__, which clang defines as well, so GCC and clang both fall back to SELENA_CACHELINE_SIZE
+// (keeping the layout the same whichever of them built it), as does every standard library which
+// doesn't define it.
+#if defined(__cpp_lib_hardware_interference_size) && !defined(__GNUC__)
+inline constexpr size_t destructive_interference_size{ std::hardware_destructive_interference_size };
+#else
+inline constexpr size_t destructive_interference_size{ SELENA_CACHELINE_SIZE };
+#endif
+
+/*
+ * A T which is alone on its cache line(s). Usage: "selena::padded<std::atomic<uint64_t>> hits{};"
+ * Access it with "*" / "->" or ".value".
+ */
+template<typename T>
+struct alignas(destructive_interference_size > alignof(T) ? destructive_interference_size : alignof(T)) padded {
+  T value{};
+
+  padded() = default;
+  template<typename... Args>
+  explicit padded(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...) {}
+
+  T& operator*() noexcept { return value; }
+  const T& operator*() const noexcept { return value; }
+  T* operator->() noexcept { return &value; }
+  const T* operator->() const noexcept { return &value; }
+}; // struct padded
+
+static_assert(sizeof(padded<char>) == destructive_interference_size);
+
+/*
+ * One padded T per CPU. Usage, for a contended counter:
+ *   selena::per_cpu<std::atomic<uint64_t>> hits{};
+ *   hits.local().fetch_add(1, std::memory_order_relaxed);                     // Any thread
+ *   const uint64_t total{ hits.combine(uint64_t{ 0 }, [](uint64_t acc, const auto& c) {
+ *     return acc + c.load(std::memory_order_relaxed); }) };
+ * A thread can be migrated between picking its slot and writing to it, so two threads may
+ * occasionally share a slot: T still has to be safe for concurrent use (an atomic, in practice).
+ * It's just that it's almost never contended.
+ */
+template<typename T>
+class per_cpu {
+public:
+  // @param slots Number of slots. 0 means one per configured CPU.
+  explicit per_cpu(const size_t slots = 0) :
+    _size{ slots ? slots : _impl_cpu_count() }, _slots{ std::make_unique<padded<T>[]>(_size) } {}
+
+  // The slots are shared by every thread, moving them around would leave those hanging
+  NO_COPY_MOVE(per_cpu)
+
+  [[nodiscard]] size_t size() const noexcept { return _size; }
+
+  // The calling CPU's slot
+  [[nodiscard]] FORCE_INLINE T& local() noexcept { return *_slots[_impl_current_cpu() % _size]; }
+
+  [[nodiscard]] T& operator[](const size_t index) noexcept { return *_slots[index]; }
+  [[nodiscard]] const T& operator[](const size_t index) const noexcept { return *_slots[index]; }
+
+  /*
+   * Folds every slot into one value - the combining read.
+   * @param init Starting value
+   * @param op Called as "acc = op(acc, slot)" for every slot, in index order
+   * @returns R The folded value
+   */
+  template<typename R, typename Op>
+  [[nodiscard]] R combine(R init, Op op) const {
+    for (size_t i{ 0 }; i < _size; ++i) init = std::invoke(op, std::move(init), *_slots[i]);
+    return init;
+  }
+
+  template<typename F>
+  void for_each(F f) {
+    for (size_t i{ 0 }; i < _size; ++i) std::invoke(f, *_slots[i]);
+  }
+
+private:
+  static size_t _impl_cpu_count() {
+#ifdef __linux__
+    const long n{ ::sysconf(_SC_NPROCESSORS_CONF) };
+    if (n > 0) return static_cast<size_t>(n);
+#endif // __linux__
+    const size_t n_threads{ std::thread::hardware_concurrency() };
+    return n_threads ? n_threads : 1;
+  }
+
+  // glibc 2.35+ answers sched_getcpu() from the rseq area the kernel keeps up to date for every
+  // thread - a plain load, no syscall. Elsewhere, threads are spread by id: not per CPU, but
+  // still per thread, which is what keeps writers apart.
+  FORCE_INLINE static size_t _impl_current_cpu() noexcept {
+#ifdef __linux__
+    const int cpu{ ::sched_getcpu() };
+    if (LIKELY(cpu >= 0)) return static_cast<size_t>(cpu);
+#endif // __linux__
+    static thread_local const size_t id{ std::hash<std::thread::id>{}(std::this_thread::get_id()) };
+    return id;
+  }
+
+  size_t _size;
+  std::unique_ptr<padded<T>[]> _slots;
+}; // class per_cpu
+} // namespace selena
+
+#endif // SELENA_PADDED_HPP
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_PERMUTATION_HPP
+#define SELENA_PERMUTATION_HPP
+
+// Keyed pseudo-random permutations of [0, n), for shuffling more IDs than fit in memory:
+//   const selena::random_permutation perm{ uint64_t{ 1 } << 40, seed };
+//   for (const uint64_t id : perm) ...   // Every ID in [0, 2^40) once, in shuffled order
+//   perm.at(i), perm.index_of(id)        // O(1) both ways, nothing stored
+// A Feistel network over the smallest number of bits covering n (with halves of unequal width when
+// that's odd, swapping roles every round), cycle-walked back into [0, n): a value which lands
+// outside goes through the network again until it's inside, under twice on average. The same seed gives the same permutation, on every platform.
+// Not a cipher - fine for sampling, spreading load and test data, not for hiding anything.
+
+#include <array>
+#include <iterator>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base.hpp"
+#include "random.hpp"
+
+namespace selena {
+class random_permutation {
+public:
+  // at(0), at(1), ..., at(n - 1), computed as they're read
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = uint64_t;
+
+    iterator() = default;
+    iterator(const random_permutation* const perm, const uint64_t index) noexcept : _perm{ perm }, _index{ index } {}
+
+    uint64_t operator*() const noexcept { return _perm->at(_index); }
+
+    iterator& operator++() noexcept {
+      ++_index;
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      iterator ret{ *this };
+      ++_index;
+      return ret;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) noexcept { return a._index == b._index; }
+    friend bool operator!=(const iterator& a, const iterator& b) noexcept { return !(a == b); }
+
+  private:
+    const random_permutation* _perm{ nullptr };
+    uint64_t _index{ 0 };
+  }; // class iterator
+
+  /*
+   * @param n Size of the domain, [0, n)
+   * @param seed Picks the permutation
+   */
+  random_permutation(const uint64_t n, const uint64_t seed) noexcept : _n{ n } {
+    unsigned bits{ 2 };
+    while (bits < 64 && (uint64_t{ 1 } << bits) < n) ++bits;
+    _left_bits = bits / 2;
+    _right_bits = bits - _left_bits;
+    _rounds = bits > 8 ? 6 : max_rounds;
+    uint64_t state{ seed };
+    for (uint64_t& key : _keys) key = _impl_mix(state += 0x9e3779b97f4a7c15ull);
+  }
+
+  // Seeded from random_prng's engine: a different permutation every time
+  explicit random_permutation(const uint64_t n) : random_permutation{ n, _impl_random_seed() } {}
+
+  [[nodiscard]] uint64_t size() const noexcept { return _n; }
+
+  /*
+   * @param i Position, in [0, size())
+   * @returns uint64_t The value at position "i". "i" itself if it's out of range.
+   */
+  [[nodiscard]] HOT uint64_t at(uint64_t i) const noexcept {
+    if (UNLIKELY(i >= _n)) return i;
+    do i = _impl_encrypt(i); while (i >= _n);
+    return i;
+  }
+
+  [[nodiscard]] uint64_t operator[](const uint64_t i) const noexcept { return at(i); }
+
+  /*
+   * The inverse of at(): index_of(at(i)) == i.
+   * @param value Value, in [0, size())
+   * @returns uint64_t Its position. "value" itself if it's out of range.
+   */
+  [[nodiscard]] uint64_t index_of(uint64_t value) const noexcept {
+    if (UNLIKELY(value >= _n)) return value;
+    do value = _impl_decrypt(value); while (value >= _n);
+    return value;
+  }
+
+  [[nodiscard]] iterator begin() const noexcept { return { this, 0 }; }
+  [[nodiscard]] iterator end() const noexcept { return { this, _n }; }
+
+private:
+  // 4 rounds make a pseudo-random permutation in theory, 6 are used. Domains of up to 256 values
+  // get twice as many (an even number either way, so the halves end up as wide as they started):
+  // with halves of a few bits, 6 rounds still favour some positions measurably.
+  static constexpr unsigned max_rounds{ 12 };
+
+  FORCE_INLINE static uint64_t _impl_low(const uint64_t x, const unsigned bits) noexcept { return x & ((uint64_t{ 1 } << bits) - 1); }
+
+  // SplitMix64's finalizer
+  FORCE_INLINE static uint64_t _impl_mix(uint64_t x) noexcept {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+  }
+
+  static uint64_t _impl_random_seed() {
+    uint64_t seed{ 0 };
+    random_prng::random_bytes(&seed, sizeof(seed));
+    return seed;
+  }
+
+  // One round: (l, r) -> (r, l ^ F(r)). The halves trade widths, as r moves to the left.
+  FORCE_INLINE uint64_t _impl_encrypt(const uint64_t x) const noexcept {
+    unsigned lb{ _left_bits }, rb{ _right_bits };
+    uint64_t l{ x >> rb }, r{ _impl_low(x, rb) };
+    for (unsigned k{ 0 }; k < _rounds; ++k) {
+      const uint64_t next{ l ^ _impl_low(_impl_mix(r ^ _keys[k]), lb) };
+      l = r;
+      r = next;
+      std::swap(lb, rb);
+    }
+    return (l << rb) | r;
+  }
+
+  FORCE_INLINE uint64_t _impl_decrypt(const uint64_t x) const noexcept {
+    unsigned lb{ _left_bits }, rb{ _right_bits };
+    uint64_t l{ x >> rb }, r{ _impl_low(x, rb) };
+    for (unsigned k{ _rounds }; k-- > 0;) {
+      const uint64_t prev{ r ^ _impl_low(_impl_mix(l ^ _keys[k]), rb) };
+      r = l;
+      l = prev;
+      std::swap(lb, rb);
+    }
+    return (l << rb) | r;
+  }
+
+  uint64_t _n;
+  unsigned _left_bits;
+  unsigned _right_bits;
+  unsigned _rounds;
+  std::array<uint64_t, max_rounds> _keys{};
+}; // class random_permutation
+} // namespace selena
+
+#endif // SELENA_PERMUTATION_HPP
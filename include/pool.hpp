@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_POOL_HPP
+#define SELENA_POOL_HPP
+
+// Fixed-size object pool, one per type, for objects which are created and destroyed often -
+// typically NO_COPY_MOVE classes which have to live behind a pointer anyway.
+// Every thread keeps its own free list, so acquire() / release() are a few pointer moves with no
+// atomics at all in the common case. A thread whose list grows past "cache_high" hands a batch of
+// slots over to a lock-free global list; a thread whose list is empty takes that whole global list
+// in one exchange, and only allocates a new chunk if it's empty too.
+// Slots are cache line aligned, so objects used by different threads never share a line.
+// Memory is never returned to the OS. Slots freed into one thread's list aren't reused by another
+// until they reach the global list, so the pool can grow past the peak number of live objects - by
+// up to "cache_high" slots per thread.
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <cstddef>
+
+#include "base.hpp"
+
+namespace selena {
+template<typename T>
+class object_pool {
+public:
+  // Same as random_prng: there's nothing to construct, the state is per type and per thread.
+  object_pool() = delete;
+
+  static constexpr size_t chunk_slots{ 64 }; // Slots allocated at once when everything's in use
+  static constexpr size_t cache_high{ 128 }; // A thread's free list never grows past this...
+  static constexpr size_t cache_batch{ 64 }; // ... it gives this many slots to the global list instead
+
+  /*
+   * Constructs a T in a pooled slot. Usage: "T* obj{ selena::object_pool<T>::acquire(args...) };"
+   * @param args Forwarded to T's constructor
+   * @returns T* Never nullptr. Give it back with release(). If T's constructor throws, so does this.
+   */
+  template<typename... Args>
+  [[nodiscard]] HOT static T* acquire(Args&&... args) {
+    _impl_slot* const slot{ _impl_pop() };
+    try {
+      return ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      _impl_push(slot);
+      throw;
+    }
+  }
+
+  /*
+   * Destroys the object and gives its slot back. Can be called from any thread, but not from one
+   * which is exiting once its free list (a thread_local) has been destroyed - ex. from the
+   * destructor of a thread_local constructed before it.
+   * @param obj Obtained from acquire() (of the same T). nullptr is ignored.
+   */
+  HOT static void release(T* const obj) noexcept {
+    if (UNLIKELY(!obj)) return;
+    obj->~T();
+    _impl_push(reinterpret_cast<_impl_slot*>(obj));
+  }
+
+  struct deleter {
+    void operator()(T* const obj) const noexcept { release(obj); }
+  };
+  using unique_ptr = std::unique_ptr<T, deleter>;
+
+  // Same as acquire(), but owned by a std::unique_ptr which calls release(). Still one pointer in size.
+  template<typename... Args>
+  [[nodiscard]] static unique_ptr make_unique(Args&&... args) {
+    return unique_ptr{ acquire(std::forward<Args>(args)...) };
+  }
+
+private:
+  static constexpr size_t slot_align{ alignof(T) > SELENA_CACHELINE_SIZE ? alignof(T) : SELENA_CACHELINE_SIZE };
+
+  // The object lives at offset 0, so a T* is also its slot's address. "next" is only used while free.
+  union alignas(slot_align) _impl_slot {
+    _impl_slot* next;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  struct _impl_cache {
+    _impl_slot* head{ nullptr };
+    size_t count{ 0 };
+
+    _impl_cache() = default;
+    // Whatever the exiting thread still holds goes to the other threads
+    ~_impl_cache() {
+      if (!head) return;
+      _impl_slot* tail{ head };
+      while (tail->next) tail = tail->next;
+      _impl_push_global(head, tail);
+    }
+
+    NO_COPY_MOVE(_impl_cache)
+  };
+
+  FORCE_INLINE static _impl_cache& _impl_local() {
+    static thread_local _impl_cache cache{};
+    return cache;
+  }
+
+  // Pushes an already linked chain. Only ever pushing (and popping everything at once, below)
+  // is what keeps this free of ABA.
+  static void _impl_push_global(_impl_slot* const first, _impl_slot* const last) noexcept {
+    _impl_slot* head{ _global.load(std::memory_order_relaxed) };
+    do {
+      last->next = head;
+    } while (!_global.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  FORCE_INLINE static _impl_slot* _impl_pop() {
+    _impl_cache& cache{ _impl_local() };
+    if (UNLIKELY(!cache.head)) _impl_refill(cache);
+    _impl_slot* const slot{ cache.head };
+    cache.head = slot->next;
+    --cache.count;
+    return slot;
+  }
+
+  FORCE_INLINE static void _impl_push(_impl_slot* const slot) noexcept {
+    _impl_cache& cache{ _impl_local() };
+    slot->next = cache.head;
+    cache.head = slot;
+    if (UNLIKELY(++cache.count > cache_high)) _impl_spill(cache);
+  }
+
+  NOINLINE static void _impl_refill(_impl_cache& cache) {
+    _impl_slot* taken{ _global.exchange(nullptr, std::memory_order_acquire) };
+    if (!taken) taken = _impl_new_chunk();
+    size_t n{ 0 };
+    for (const _impl_slot* s{ taken }; s; s = s->next) ++n;
+    cache.head = taken;
+    cache.count = n;
+  }
+
+  NOINLINE static void _impl_spill(_impl_cache& cache) noexcept {
+    _impl_slot* const first{ cache.head };
+    _impl_slot* last{ first };
+    for (size_t i{ 1 }; i < cache_batch; ++i) last = last->next;
+    cache.head = last->next;
+    cache.count -= cache_batch;
+    _impl_push_global(first, last);
+  }
+
+  // Slot 0 of every chunk links the chunks together, so they stay reachable (leak checkers)
+  static _impl_slot* _impl_new_chunk() {
+    _impl_slot* const chunk{ static_cast<_impl_slot*>(
+      ::operator new(sizeof(_impl_slot) * (chunk_slots + 1), std::align_val_t{ alignof(_impl_slot) })) };
+    chunk[0].next = _chunks.load(std::memory_order_relaxed);
+    while (!_chunks.compare_exchange_weak(chunk[0].next, chunk, std::memory_order_relaxed)) {}
+
+    for (size_t i{ 1 }; i < chunk_slots; ++i) chunk[i].next = &chunk[i + 1];
+    chunk[chunk_slots].next = nullptr;
+    return &chunk[1];
+  }
+
+  inline static std::atomic<_impl_slot*> _global{ nullptr };
+  inline static std::atomic<_impl_slot*> _chunks{ nullptr };
+}; // class object_pool
+} // namespace selena
+
+#endif // SELENA_POOL_HPP
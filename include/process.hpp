@@ -0,0 +1,505 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_PROCESS_HPP
+#define SELENA_PROCESS_HPP
+
+// posix_spawn() based process launcher. POSIX only - on Windows, stick to selena::system().
+#ifndef _WIN32
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+  #include <poll.h>
+  #include <sys/syscall.h>
+#endif // __linux__
+
+#include "instrument.hpp"
+
+extern "C" char** environ;
+
+namespace selena {
+// Limits applied to the child before it execs. Leaving everything at the defaults applies nothing.
+struct resource_limits {
+  // RLIMIT_CPU, in seconds of CPU time. SIGXCPU when reached, SIGKILL a second later.
+  rlim_t cpu_seconds{ RLIM_INFINITY };
+  // RLIMIT_AS, in bytes. Note that this caps address space, not RSS - for a real memory cap,
+  // set "memory.max" on a cgroup and use "cgroup" below.
+  rlim_t memory_bytes{ RLIM_INFINITY };
+  // A cgroup v2 directory (ex. "/sys/fs/cgroup/batch") the child is moved into before it execs.
+  // Creating it and writing its "cpu.max" / "memory.max" is up to the caller.
+  const char* cgroup{ nullptr };
+
+  [[nodiscard]] bool any() const {
+    return cpu_seconds != RLIM_INFINITY || memory_bytes != RLIM_INFINITY || cgroup;
+  }
+};
+
+struct spawn_options {
+  // Wires the child's stdout and stderr to /dev/null. No shell redirection involved.
+  bool suppressed{ false };
+  // Resolves argv[0] through $PATH (posix_spawnp) instead of treating it as a path.
+  bool search_path{ true };
+  // If set, dup2()'ed onto the child's stdout / stderr. Applied after "suppressed", so these win.
+  int stdout_fd{ -1 };
+  int stderr_fd{ -1 };
+  // posix_spawn() can't apply these, so setting any of them makes the launcher fork() instead.
+  resource_limits limits{};
+};
+
+struct command_result {
+  // The wait status, same as std::system(). -1 if the command couldn't be started.
+  int status{ -1 };
+  // From spawning to reaping
+  std::chrono::nanoseconds duration{ 0 };
+  std::chrono::nanoseconds user_cpu{ 0 };
+  std::chrono::nanoseconds system_cpu{ 0 };
+  // Peak resident set size of the child, in KiB (ru_maxrss)
+  long max_rss_kb{ 0 };
+  long voluntary_switches{ 0 };
+  long involuntary_switches{ 0 };
+};
+
+namespace detail {
+// Opened exactly once per process, and kept open for the lifetime of the process.
+// O_CLOEXEC doesn't matter for the child: dup2() onto 1/2 clears the flag on the new descriptors.
+inline int _impl_dev_null() {
+  static const int fd{ ::open("/dev/null", O_WRONLY | O_CLOEXEC) };
+  return fd;
+}
+
+#ifdef __linux__
+inline int _impl_pidfd_open(const pid_t pid) {
+  return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+}
+#endif // __linux__
+
+inline int _impl_waitpid(const pid_t pid) {
+  int status{ 0 };
+  while (::waitpid(pid, &status, 0) == -1)
+    if (errno != EINTR) return -1;
+  return status;
+}
+
+// Characters which are taken literally by /bin/sh when they appear in an unquoted word.
+// Anything outside this set (quotes, globs, redirections, '$', '~', ...) needs the shell.
+inline bool _impl_is_shell_literal(const unsigned char c) {
+  if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) return true;
+  switch (c) {
+    case ' ': case '\t': case '_': case '-': case '.': case '/':
+    case ':': case ',': case '+': case '@': case '%': case '^': case '=':
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline void _impl_fill_result(command_result& result, const int status, const rusage& usage,
+  const std::chrono::steady_clock::time_point start) {
+  const auto to_ns = [](const timeval tv) {
+    return std::chrono::seconds{ tv.tv_sec } + std::chrono::microseconds{ tv.tv_usec };
+  };
+  result.status = status;
+  result.duration = std::chrono::steady_clock::now() - start;
+  result.user_cpu = to_ns(usage.ru_utime);
+  result.system_cpu = to_ns(usage.ru_stime);
+  result.max_rss_kb = usage.ru_maxrss;
+  result.voluntary_switches = usage.ru_nvcsw;
+  result.involuntary_switches = usage.ru_nivcsw;
+}
+
+// fork() based launcher, for when there's something to do in the child which posix_spawn() can't do.
+// Exec failures are reported back through a close-on-exec pipe, so the return value matches spawn().
+inline int _impl_spawn_forked(const char* const* const argv, pid_t& pid, const spawn_options& opts) {
+  int cgroup_fd{ -1 };
+  if (opts.limits.cgroup) {
+    char path[4096];
+    if (std::snprintf(path, sizeof(path), "%s/cgroup.procs", opts.limits.cgroup) >= static_cast<int>(sizeof(path)))
+      return ENAMETOOLONG;
+    cgroup_fd = ::open(path, O_WRONLY | O_CLOEXEC);
+    if (cgroup_fd == -1) return errno;
+  }
+
+  int err_pipe[2];
+#ifdef __linux__
+  // Atomically close-on-exec: a fork() from another thread in between would keep the write end open
+  const int piped{ ::pipe2(err_pipe, O_CLOEXEC) };
+#else // ^^^ __linux__ || !__linux__ vvv
+  const int piped{ ::pipe(err_pipe) };
+#endif // __linux__
+  if (piped == -1) {
+    const int err{ errno };
+    if (cgroup_fd != -1) ::close(cgroup_fd);
+    return err;
+  }
+#ifndef __linux__
+  ::fcntl(err_pipe[0], F_SETFD, FD_CLOEXEC);
+  ::fcntl(err_pipe[1], F_SETFD, FD_CLOEXEC);
+#endif // __linux__
+  const int dev_null{ opts.suppressed ? _impl_dev_null() : -1 };
+
+  SELENA_COUNT(spawns, 1);
+  SELENA_COUNT(forked_spawns, 1);
+  pid = ::fork();
+  if (!pid) {
+    // Only async-signal-safe calls from here on
+    const auto fail = [&err_pipe]() {
+      const int err{ errno };
+      (void)!::write(err_pipe[1], &err, sizeof(err));
+      ::_exit(127);
+    };
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    ::sigprocmask(SIG_SETMASK, &mask, nullptr);
+    ::signal(SIGINT, SIG_DFL);
+    ::signal(SIGQUIT, SIG_DFL);
+    ::signal(SIGPIPE, SIG_DFL);
+
+    // "0" moves the writing process itself
+    if (cgroup_fd != -1 && ::write(cgroup_fd, "0", 1) == -1) fail();
+    if (opts.limits.cpu_seconds != RLIM_INFINITY) {
+      const rlimit lim{ opts.limits.cpu_seconds, opts.limits.cpu_seconds + 1 };
+      if (::setrlimit(RLIMIT_CPU, &lim) == -1) fail();
+    }
+    if (opts.limits.memory_bytes != RLIM_INFINITY) {
+      const rlimit lim{ opts.limits.memory_bytes, opts.limits.memory_bytes };
+      if (::setrlimit(RLIMIT_AS, &lim) == -1) fail();
+    }
+
+    if (opts.suppressed) {
+      const int null_fd{ dev_null != -1 ? dev_null : ::open("/dev/null", O_WRONLY) };
+      if (null_fd == -1 || ::dup2(null_fd, STDOUT_FILENO) == -1 || ::dup2(null_fd, STDERR_FILENO) == -1) fail();
+    }
+    if (opts.stdout_fd != -1 && ::dup2(opts.stdout_fd, STDOUT_FILENO) == -1) fail();
+    if (opts.stderr_fd != -1 && ::dup2(opts.stderr_fd, STDERR_FILENO) == -1) fail();
+
+    char* const* const args{ const_cast<char* const*>(argv) };
+    if (opts.search_path) ::execvp(argv[0], args);
+    else ::execv(argv[0], args);
+    fail();
+  }
+
+  const int fork_err{ pid == -1 ? errno : 0 };
+  ::close(err_pipe[1]);
+  if (cgroup_fd != -1) ::close(cgroup_fd);
+  if (fork_err) {
+    ::close(err_pipe[0]);
+    return fork_err;
+  }
+
+  int child_err{ 0 };
+  ssize_t got{ 0 };
+  do got = ::read(err_pipe[0], &child_err, sizeof(child_err)); while (got == -1 && errno == EINTR);
+  ::close(err_pipe[0]);
+  if (got != static_cast<ssize_t>(sizeof(child_err))) return 0; // EOF - exec went through
+
+  _impl_waitpid(pid);
+  return child_err;
+}
+} // namespace detail
+
+/*
+ * Spawns a child process without going through a shell. The child isn't waited for.
+ * Usage: "pid_t pid; if (const int err{ spawn(argv, pid) }; err) ..."
+ * @param argv A nullptr-terminated argument vector, argv[0] being the program
+ * @param pid Receives the child's pid on success
+ * @param opts See selena::spawn_options
+ * @returns int 0 on success, otherwise an errno value (ENOENT if the program couldn't be found, etc.)
+ */
+[[nodiscard]] inline int spawn(const char* const* const argv, pid_t& pid, const spawn_options& opts = {}) {
+  if (!argv || !argv[0]) return EINVAL;
+  if (opts.limits.any()) return detail::_impl_spawn_forked(argv, pid, opts);
+  SELENA_COUNT(spawns, 1);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  if (const int err{ ::posix_spawn_file_actions_init(&actions) }; err) return err;
+  if (const int err{ ::posix_spawnattr_init(&attr) }; err) {
+    ::posix_spawn_file_actions_destroy(&actions);
+    return err;
+  }
+
+  int err{ 0 };
+  if (opts.suppressed) {
+    if (const int dev_null{ detail::_impl_dev_null() }; dev_null != -1) {
+      err = ::posix_spawn_file_actions_adddup2(&actions, dev_null, STDOUT_FILENO);
+      if (!err) err = ::posix_spawn_file_actions_adddup2(&actions, dev_null, STDERR_FILENO);
+    } else { // Couldn't keep one around, let the child open it instead
+      err = ::posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+      if (!err) err = ::posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+    }
+  }
+  if (!err && opts.stdout_fd != -1) err = ::posix_spawn_file_actions_adddup2(&actions, opts.stdout_fd, STDOUT_FILENO);
+  if (!err && opts.stderr_fd != -1) err = ::posix_spawn_file_actions_adddup2(&actions, opts.stderr_fd, STDERR_FILENO);
+
+  // Same as what std::system() gives its child: an empty signal mask and default SIGINT/SIGQUIT.
+  // SIGPIPE too, since servers commonly ignore it and an ignored disposition survives exec.
+  sigset_t mask;
+  sigemptyset(&mask);
+  if (!err) err = ::posix_spawnattr_setsigmask(&attr, &mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGQUIT);
+  sigaddset(&mask, SIGPIPE);
+  if (!err) err = ::posix_spawnattr_setsigdefault(&attr, &mask);
+  if (!err) err = ::posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+  if (!err) {
+    char* const* const args{ const_cast<char* const*>(argv) };
+    err = opts.search_path ? ::posix_spawnp(&pid, argv[0], &actions, &attr, args, environ)
+                           : ::posix_spawn(&pid, argv[0], &actions, &attr, args, environ);
+  }
+
+  ::posix_spawnattr_destroy(&attr);
+  ::posix_spawn_file_actions_destroy(&actions);
+  return err;
+}
+
+/*
+ * Spawns a child process without going through a shell, and waits for it.
+ * @param argv A nullptr-terminated argument vector, argv[0] being the program
+ * @param opts See selena::spawn_options
+ * @returns int The wait status, same as std::system(). 127 << 8 if the program couldn't be executed
+ * (which is what a shell would report), -1 if the child couldn't be created at all.
+ */
+[[nodiscard]] inline int run(const char* const* const argv, const spawn_options& opts = {}) {
+  SELENA_TIME(run);
+  pid_t pid{ 0 };
+  if (const int err{ spawn(argv, pid, opts) }; err)
+    return (err == ENOENT || err == EACCES || err == ENOEXEC) ? (127 << 8) : -1;
+  return detail::_impl_waitpid(pid);
+}
+
+/*
+ * Same as selena::run(), but also reports what the child cost. Combine with spawn_options::limits
+ * to cap the expensive ones.
+ * @param argv A nullptr-terminated argument vector, argv[0] being the program
+ * @param opts See selena::spawn_options
+ * @returns command_result The wait status (as returned by run()), along with the child's rusage
+ */
+[[nodiscard]] inline command_result run_measured(const char* const* const argv, const spawn_options& opts = {}) {
+  SELENA_TIME(run_measured);
+  command_result result{};
+  const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+  pid_t pid{ 0 };
+  if (const int err{ spawn(argv, pid, opts) }; err) {
+    result.status = (err == ENOENT || err == EACCES || err == ENOEXEC) ? (127 << 8) : -1;
+    return result;
+  }
+
+  int status{ -1 };
+  rusage usage{};
+  while (::wait4(pid, &status, 0, &usage) == -1) {
+    if (errno != EINTR) return result;
+  }
+  detail::_impl_fill_result(result, status, usage, start);
+  return result;
+}
+
+/*
+ * Spawns a shell command line, without waiting for it. If the command is nothing but plain words
+ * (no quotes, globs, redirections, variables etc.), it is split on whitespace and executed directly -
+ * no /bin/sh, no heap allocation. Everything else, including shell builtins, goes through "/bin/sh -c".
+ * @param cmd A C-style string which specifies the command
+ * @param pid Receives the child's pid on success
+ * @param opts See selena::spawn_options. "search_path" is ignored, words are always looked up in $PATH.
+ * @returns int 0 on success, otherwise an errno value
+ */
+[[nodiscard]] inline int spawn_shell(const char* const cmd, pid_t& pid, const spawn_options& opts = {}) {
+  if (!cmd) return EINVAL;
+
+  // Fast path: tokenize into a stack buffer. Too long / too many words -> let the shell handle it.
+  constexpr size_t max_len{ 512 };
+  constexpr size_t max_args{ 32 };
+  char buf[max_len];
+  const char* argv[max_args + 1]{};
+
+  bool direct{ true };
+  size_t len{ 0 }, argc{ 0 };
+  for (; cmd[len]; ++len) {
+    if (len + 1 >= max_len || !detail::_impl_is_shell_literal(static_cast<unsigned char>(cmd[len]))) {
+      direct = false;
+      break;
+    }
+  }
+
+  if (direct) {
+    std::memcpy(buf, cmd, len + 1);
+    for (size_t i{ 0 }; i < len && direct;) {
+      while (i < len && (buf[i] == ' ' || buf[i] == '\t')) buf[i++] = '\0';
+      if (i == len) break;
+      if (argc == max_args) direct = false;
+      else argv[argc++] = buf + i;
+      while (i < len && buf[i] != ' ' && buf[i] != '\t') ++i;
+    }
+    // "VAR=value cmd" is an assignment, not a program named "VAR=value"
+    if (!argc || std::strchr(argv[0], '=')) direct = false;
+  }
+
+  spawn_options shell_opts{ opts };
+  shell_opts.search_path = true;
+  if (direct) {
+    const int err{ spawn(argv, pid, shell_opts) };
+    if (err != ENOENT && err != EACCES && err != ENOEXEC) return err;
+    // Couldn't be executed. Might be a builtin ("cd", "exit", ...), the shell knows better
+    // (and also reports 127/126 the way callers expect).
+  }
+
+  const char* const sh_argv[]{ "/bin/sh", "-c", cmd, nullptr };
+  shell_opts.search_path = false;
+  SELENA_COUNT(shell_spawns, 1);
+  return spawn(sh_argv, pid, shell_opts);
+}
+
+/*
+ * Runs a shell command line and waits for it. See selena::spawn_shell() for when /bin/sh is skipped.
+ * @param cmd A C-style string which specifies the command
+ * @param opts See selena::spawn_options
+ * @returns int The wait status, same as std::system()
+ */
+[[nodiscard]] inline int run_shell(const char* const cmd, const spawn_options& opts = {}) {
+  SELENA_TIME(run_shell);
+  if (!cmd) return 1;
+  pid_t pid{ 0 };
+  if (const int err{ spawn_shell(cmd, pid, opts) }; err) return -1;
+  return detail::_impl_waitpid(pid);
+}
+
+/*
+ * Runs a list of shell commands, up to "max_parallel" of them at a time, and waits for all of them.
+ * Each command goes through selena::spawn_shell(). On Linux, children are reaped through a single
+ * poll() over their pidfds. Elsewhere, wait4(-1) is used, so don't mix this with other children
+ * of the calling process there.
+ * @param commands The command lines
+ * @param max_parallel Upper bound on concurrently running children. 0 means one per hardware thread.
+ * @param opts See selena::spawn_options
+ * @returns std::vector<command_result> One result per command, in the same order
+ */
+[[nodiscard]] inline std::vector<command_result> run_all(const std::vector<std::string>& commands, size_t max_parallel = 0,
+  const spawn_options& opts = {}) {
+  SELENA_TIME(run_all);
+  using clock = std::chrono::steady_clock;
+  if (!max_parallel) max_parallel = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+  std::vector<command_result> results(commands.size());
+  struct running { size_t index; pid_t pid; clock::time_point start; };
+  std::vector<running> active{};
+  active.reserve(std::min(max_parallel, commands.size()));
+
+  const auto finish = [&results](const running& r, const int status, const rusage& usage) {
+    detail::_impl_fill_result(results[r.index], status, usage, r.start);
+  };
+
+#ifdef __linux__
+  std::vector<pollfd> fds{};
+  fds.reserve(active.capacity());
+#endif // __linux__
+
+  size_t next{ 0 };
+  while (next < commands.size() || !active.empty()) {
+    while (active.size() < max_parallel && next < commands.size()) {
+      const size_t index{ next++ };
+      running r{ index, 0, clock::now() };
+      if (spawn_shell(commands[index].c_str(), r.pid, opts)) continue; // status stays -1
+#ifdef __linux__
+      const int pidfd{ detail::_impl_pidfd_open(r.pid) };
+      if (pidfd == -1) { // No pidfds (old kernel). Degrade to waiting for this one right away.
+        int status{ -1 };
+        rusage usage{};
+        while (::wait4(r.pid, &status, 0, &usage) == -1 && errno == EINTR) {}
+        finish(r, status, usage);
+        continue;
+      }
+      fds.push_back({ pidfd, POLLIN, 0 });
+#endif // __linux__
+      active.push_back(r);
+    }
+    if (active.empty()) continue;
+
+#ifdef __linux__
+    if (::poll(fds.data(), fds.size(), -1) == -1) {
+      if (errno == EINTR) continue;
+      // poll() itself failed: block on one child instead, as without pidfds, so none is left a zombie
+      for (pollfd& fd : fds) fd.revents = 0;
+      fds[0].revents = POLLIN;
+    }
+    for (size_t i{ 0 }; i < fds.size();) {
+      if (!fds[i].revents) {
+        ++i;
+        continue;
+      }
+      int status{ -1 };
+      rusage usage{};
+      while (::wait4(active[i].pid, &status, 0, &usage) == -1 && errno == EINTR) {}
+      finish(active[i], status, usage);
+      ::close(fds[i].fd);
+      fds[i] = fds.back();
+      fds.pop_back();
+      active[i] = active.back();
+      active.pop_back();
+    }
+#else // ^^^ __linux__ || !__linux__ vvv
+    int status{ -1 };
+    rusage usage{};
+    const pid_t pid{ ::wait4(-1, &status, 0, &usage) };
+    if (pid == -1) {
+      if (errno == EINTR) continue;
+      // Reap the children one by one instead, so none is left a zombie
+      const running r{ active.back() };
+      active.pop_back();
+      status = -1;
+      while (::wait4(r.pid, &status, 0, &usage) == -1 && errno == EINTR) {}
+      finish(r, status, usage);
+      continue;
+    }
+    for (size_t i{ 0 }; i < active.size(); ++i) {
+      if (active[i].pid != pid) continue;
+      finish(active[i], status, usage);
+      active[i] = active.back();
+      active.pop_back();
+      break;
+    }
+#endif // __linux__
+  }
+
+#ifdef __linux__
+  for (const pollfd& fd : fds) ::close(fd.fd);
+#endif // __linux__
+  return results;
+}
+} // namespace selena
+
+#endif // _WIN32
+
+#endif // SELENA_PROCESS_HPP
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_QUEUE_HPP
+#define SELENA_QUEUE_HPP
+
+// Bounded lock-free queues for handing work between threads.
+// mpmc_queue: any number of producers and consumers. Dmitry Vyukov's bounded MPMC ring - every
+//   slot carries a sequence number telling whether it's ready to be written or read on the
+//   current lap, so producers and consumers only ever contend on their own index.
+// spsc_queue: exactly one producer and one consumer thread. No read-modify-writes at all, and
+//   each side keeps a cached copy of the other's index to touch the shared line as rarely as possible.
+// Both are non-blocking: try_push() fails when full, try_pop() when empty. The *_bulk() variants
+// move several elements for a single index update.
+// Once a slot is claimed it has to be filled, so T's constructors used by the pushes (and its
+// move assignment, used by the pops) must not throw.
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+#include "base.hpp"
+
+namespace selena {
+namespace detail {
+inline size_t _impl_ceil_pow2(size_t n) {
+  size_t ret{ 2 };
+  while (ret < n) ret <<= 1;
+  return ret;
+}
+} // namespace detail
+
+template<typename T>
+class mpmc_queue {
+public:
+  // @param capacity Rounded up to a power of two, at least 2
+  explicit mpmc_queue(const size_t capacity) :
+    _mask{ detail::_impl_ceil_pow2(capacity) - 1 }, _slots{ std::make_unique<_impl_slot[]>(_mask + 1) } {
+    for (size_t i{ 0 }; i <= _mask; ++i) _slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  ~mpmc_queue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      const size_t head{ _head.load(std::memory_order_relaxed) };
+      for (size_t pos{ _tail.load(std::memory_order_relaxed) }; pos != head; ++pos)
+        std::launder(reinterpret_cast<T*>(_slots[pos & _mask].storage))->~T();
+    }
+  }
+
+  // Threads hold on to it
+  NO_COPY_MOVE(mpmc_queue)
+
+  [[nodiscard]] size_t capacity() const noexcept { return _mask + 1; }
+
+  // Only a snapshot, others may be pushing / popping
+  [[nodiscard]] size_t size_approx() const noexcept {
+    const size_t head{ _head.load(std::memory_order_relaxed) };
+    const size_t tail{ _tail.load(std::memory_order_relaxed) };
+    return head > tail ? head - tail : 0;
+  }
+
+  /*
+   * @param args Forwarded to T's constructor
+   * @returns bool false if the queue is full
+   */
+  template<typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t pos{ _head.load(std::memory_order_relaxed) };
+    for (;;) {
+      _impl_slot& slot{ _slots[pos & _mask] };
+      const size_t seq{ slot.seq.load(std::memory_order_acquire) };
+      const std::ptrdiff_t diff{ static_cast<std::ptrdiff_t>(seq - pos) };
+      if (diff == 0) {
+        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          ::new (static_cast<void*>(slot.storage)) T(std::forward<Args>(args)...);
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // Last lap's element hasn't been popped yet
+      } else {
+        pos = _head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool try_push(const T& value) { return try_emplace(value); }
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  /*
+   * @param out Receives the element
+   * @returns bool false if the queue is empty
+   */
+  bool try_pop(T& out) {
+    size_t pos{ _tail.load(std::memory_order_relaxed) };
+    for (;;) {
+      _impl_slot& slot{ _slots[pos & _mask] };
+      const size_t seq{ slot.seq.load(std::memory_order_acquire) };
+      const std::ptrdiff_t diff{ static_cast<std::ptrdiff_t>(seq - (pos + 1)) };
+      if (diff == 0) {
+        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          _impl_take(slot, out);
+          slot.seq.store(pos + _mask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /*
+   * Pushes up to "count" elements with a single claim on the head index.
+   * @param first Iterator to the first element, copied (or moved, with std::make_move_iterator)
+   * @param count Number of elements available at "first"
+   * @returns size_t How many were pushed, from the front. Less than "count" if the queue filled up.
+   */
+  template<typename It>
+  size_t try_push_bulk(It first, const size_t count) {
+    size_t pos{ _head.load(std::memory_order_relaxed) };
+    size_t n{ 0 };
+    for (;;) {
+      // A slot which is ready for this lap stays ready until whoever claims its position writes
+      // it, so counting them first and claiming them all with one CAS is safe.
+      n = 0;
+      while (n < count && _slots[(pos + n) & _mask].seq.load(std::memory_order_acquire) == pos + n) ++n;
+      if (!n) {
+        const size_t now{ _head.load(std::memory_order_relaxed) };
+        if (now == pos) return 0;
+        pos = now;
+        continue;
+      }
+      if (_head.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+    }
+    for (size_t i{ 0 }; i < n; ++i, ++first) {
+      _impl_slot& slot{ _slots[(pos + i) & _mask] };
+      ::new (static_cast<void*>(slot.storage)) T(*first);
+      slot.seq.store(pos + i + 1, std::memory_order_release);
+    }
+    return n;
+  }
+
+  /*
+   * Pops up to "max" elements with a single claim on the tail index.
+   * @param out Output iterator, ex. a T* or std::back_inserter
+   * @param max Most elements to pop
+   * @returns size_t How many were popped
+   */
+  template<typename OutIt>
+  size_t try_pop_bulk(OutIt out, const size_t max) {
+    size_t pos{ _tail.load(std::memory_order_relaxed) };
+    size_t n{ 0 };
+    for (;;) {
+      n = 0;
+      while (n < max && _slots[(pos + n) & _mask].seq.load(std::memory_order_acquire) == pos + n + 1) ++n;
+      if (!n) {
+        const size_t now{ _tail.load(std::memory_order_relaxed) };
+        if (now == pos) return 0;
+        pos = now;
+        continue;
+      }
+      if (_tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+    }
+    for (size_t i{ 0 }; i < n; ++i, ++out) {
+      _impl_slot& slot{ _slots[(pos + i) & _mask] };
+      T* const value{ std::launder(reinterpret_cast<T*>(slot.storage)) };
+      *out = std::move(*value);
+      value->~T();
+      slot.seq.store(pos + i + _mask + 1, std::memory_order_release);
+    }
+    return n;
+  }
+
+private:
+  struct _impl_slot {
+    std::atomic<size_t> seq{ 0 };
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  static void _impl_take(_impl_slot& slot, T& out) {
+    T* const value{ std::launder(reinterpret_cast<T*>(slot.storage)) };
+    out = std::move(*value);
+    value->~T();
+  }
+
+  const size_t _mask;
+  const std::unique_ptr<_impl_slot[]> _slots;
+  CACHELINE_ALIGNED std::atomic<size_t> _head{ 0 }; // Next position to push to
+  CACHELINE_ALIGNED std::atomic<size_t> _tail{ 0 }; // Next position to pop from
+}; // class mpmc_queue
+
+template<typename T>
+class spsc_queue {
+public:
+  // @param capacity Rounded up to a power of two, at least 2
+  explicit spsc_queue(const size_t capacity) :
+    _mask{ detail::_impl_ceil_pow2(capacity) - 1 }, _slots{ std::make_unique<_impl_slot[]>(_mask + 1) } {}
+
+  ~spsc_queue() {
+    for (size_t i{ _tail.load(std::memory_order_relaxed) }; i != _head.load(std::memory_order_relaxed); ++i)
+      _impl_at(i)->~T();
+  }
+
+  // Threads hold on to it
+  NO_COPY_MOVE(spsc_queue)
+
+  [[nodiscard]] size_t capacity() const noexcept { return _mask + 1; }
+
+  [[nodiscard]] size_t size_approx() const noexcept {
+    return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+  }
+
+  // Producer only. false if the queue is full.
+  template<typename... Args>
+  bool try_emplace(Args&&... args) {
+    const size_t head{ _head.load(std::memory_order_relaxed) };
+    if (head - _tail_cache > _mask) {
+      _tail_cache = _tail.load(std::memory_order_acquire);
+      if (head - _tail_cache > _mask) return false;
+    }
+    ::new (static_cast<void*>(_slots[head & _mask].storage)) T(std::forward<Args>(args)...);
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const T& value) { return try_emplace(value); }
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  // Consumer only. false if the queue is empty.
+  bool try_pop(T& out) {
+    const size_t tail{ _tail.load(std::memory_order_relaxed) };
+    if (tail == _head_cache) {
+      _head_cache = _head.load(std::memory_order_acquire);
+      if (tail == _head_cache) return false;
+    }
+    T* const value{ _impl_at(tail) };
+    out = std::move(*value);
+    value->~T();
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Producer only. Same as mpmc_queue::try_push_bulk().
+  template<typename It>
+  size_t try_push_bulk(It first, const size_t count) {
+    const size_t head{ _head.load(std::memory_order_relaxed) };
+    size_t free{ _mask + 1 - (head - _tail_cache) };
+    if (free < count) {
+      _tail_cache = _tail.load(std::memory_order_acquire);
+      free = _mask + 1 - (head - _tail_cache);
+    }
+    const size_t n{ count < free ? count : free };
+    for (size_t i{ 0 }; i < n; ++i, ++first) ::new (static_cast<void*>(_slots[(head + i) & _mask].storage)) T(*first);
+    _head.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // Consumer only. Same as mpmc_queue::try_pop_bulk().
+  template<typename OutIt>
+  size_t try_pop_bulk(OutIt out, const size_t max) {
+    const size_t tail{ _tail.load(std::memory_order_relaxed) };
+    size_t available{ _head_cache - tail };
+    if (available < max) {
+      _head_cache = _head.load(std::memory_order_acquire);
+      available = _head_cache - tail;
+    }
+    const size_t n{ max < available ? max : available };
+    for (size_t i{ 0 }; i < n; ++i, ++out) {
+      T* const value{ _impl_at(tail + i) };
+      *out = std::move(*value);
+      value->~T();
+    }
+    _tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+private:
+  struct _impl_slot {
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  T* _impl_at(const size_t pos) { return std::launder(reinterpret_cast<T*>(_slots[pos & _mask].storage)); }
+
+  const size_t _mask;
+  const std::unique_ptr<_impl_slot[]> _slots;
+  CACHELINE_ALIGNED std::atomic<size_t> _head{ 0 }; // Written by the producer
+  size_t _tail_cache{ 0 };                          // Producer's view of _tail
+  CACHELINE_ALIGNED std::atomic<size_t> _tail{ 0 }; // Written by the consumer
+  size_t _head_cache{ 0 };                          // Consumer's view of _head
+}; // class spsc_queue
+} // namespace selena
+
+#endif // SELENA_QUEUE_HPP
@@ -19,10 +19,395 @@
 #define SELENA_RANDOM_HPP
 
 #include <vector>
+#include <algorithm>
 #include <array>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__) && __has_include(<sys/random.h>)
+  #include <sys/random.h>
+#endif
+
+#include "base.hpp"
+#include "instrument.hpp"
+#include "thread_pool.hpp"
 
 namespace selena {
+namespace detail {
+/*
+ * Fills "dest" with characters of "alphabet", each equally likely (per occurrence in "alphabet").
+ * "fill" is called as fill(uint64_t* words, size_t count) to get random words in bulk.
+ * - Power of two alphabets (hex, base64url, ...) take log2(size) bits per character and waste none.
+ * - Other alphabets of up to 256 characters take a byte per character. The bytes which would
+ *   make some characters likelier (256 % size of them) are rejected rather than folded in.
+ * - Larger ones do the same with 32-bit chunks.
+ */
+template<typename Fill>
+void _impl_random_string(const std::string_view alphabet, char* dest, size_t length, Fill&& fill) {
+  const size_t k{ alphabet.size() };
+  if (UNLIKELY(!k)) return;
+  if (k == 1) {
+    for (size_t i{ 0 }; i < length; ++i) dest[i] = alphabet[0];
+    return;
+  }
+
+  constexpr size_t batch{ 64 };
+  uint64_t words[batch];
+
+  if (!(k & (k - 1))) {
+    unsigned bits{ 0 };
+    while ((size_t{ 1 } << bits) < k) ++bits;
+    const unsigned per_word{ 64 / bits };
+    const uint64_t mask{ k - 1 };
+    while (length) {
+      const size_t needed{ (length + per_word - 1) / per_word };
+      const size_t n{ needed < batch ? needed : batch };
+      fill(words, n);
+      for (size_t w{ 0 }; w < n && length; ++w) {
+        uint64_t word{ words[w] };
+        for (unsigned c{ 0 }; c < per_word && length; ++c, --length, word >>= bits) *dest++ = alphabet[word & mask];
+      }
+    }
+    return;
+  }
+
+  if (k <= 256) {
+    // Lemire's multiply-shift: byte b maps to (b * k) >> 8, which is what a byte -> character
+    // table would hold, without building one per call. The low byte of b * k tells which of the
+    // 256 % k leftover values a byte is - those are rejected, so every character is equally likely.
+    const unsigned threshold{ static_cast<unsigned>(256 % k) };
+    while (length) {
+      // Expected bytes needed, with some slack for rejections
+      const size_t needed{ (length * 256 / (256 - threshold) + 8 + 7) / 8 };
+      const size_t n{ needed < batch ? needed : batch };
+      fill(words, n);
+      const unsigned char* const bytes{ reinterpret_cast<const unsigned char*>(words) };
+      for (size_t i{ 0 }; i < n * 8 && length; ++i) {
+        const unsigned m{ bytes[i] * static_cast<unsigned>(k) };
+        if ((m & 0xff) < threshold) continue;
+        *dest++ = alphabet[m >> 8];
+        --length;
+      }
+    }
+    return;
+  }
+
+  const uint64_t limit{ (uint64_t{ 1 } << 32) - (uint64_t{ 1 } << 32) % k };
+  while (length) {
+    const size_t needed{ (length + 1) / 2 + 1 };
+    const size_t n{ needed < batch ? needed : batch };
+    fill(words, n);
+    for (size_t w{ 0 }; w < n && length; ++w) {
+      for (const uint64_t chunk : { words[w] & 0xffffffffu, words[w] >> 32 }) {
+        if (chunk >= limit || !length) continue;
+        *dest++ = alphabet[chunk % k];
+        --length;
+      }
+    }
+  }
+}
+
+// Anything with std::size() and operator[]: std::deque, std::string_view, generated(), and in
+// C++20 std::span or std::views::iota(0, n) (| std::views::transform(fn), ...)
+template<typename R, typename = void>
+struct _impl_is_indexable : std::false_type {};
+
+template<typename R>
+struct _impl_is_indexable<R, std::void_t<decltype(std::size(std::declval<const R&>())),
+  decltype(std::declval<const R&>()[std::size(std::declval<const R&>())])>> : std::true_type {};
+
+template<typename R>
+using _impl_indexed_t = std::decay_t<decltype(std::declval<const R&>()[std::size(std::declval<const R&>())])>;
+
+// Interval [lo, hi] of any integer type, as an offset range which can't overflow: [0, span]
+template<typename T>
+struct _impl_interval {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "random_in() takes integers");
+
+  uint64_t base;
+  uint64_t span;
+
+  _impl_interval(const T lo, const T hi) : base{ static_cast<uint64_t>(lo) }, span{ static_cast<uint64_t>(hi) - base } {}
+  FORCE_INLINE T at(const uint64_t offset) const { return static_cast<T>(base + offset); }
+};
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 _impl_uint128;
+#endif
+
+/*
+ * Uniform in [0, n), n > 0. With a 64-bit engine, Lemire's nearly divisionless method: the top half
+ * of engine() * n, and a division only for the rare low halves which could bias the result.
+ * Other engines go through std::uniform_int_distribution.
+ */
+template<typename Engine>
+FORCE_INLINE uint64_t _impl_bounded(Engine& engine, const uint64_t n) {
+#if defined(__SIZEOF_INT128__)
+  if constexpr (Engine::min() == 0 && Engine::max() == UINT64_MAX) {
+    _impl_uint128 m{ static_cast<_impl_uint128>(engine()) * n };
+    if (UNLIKELY(static_cast<uint64_t>(m) < n)) {
+      const uint64_t threshold{ (0 - n) % n };
+      while (static_cast<uint64_t>(m) < threshold) m = static_cast<_impl_uint128>(engine()) * n;
+    }
+    return static_cast<uint64_t>(m >> 64);
+  }
+#endif
+  std::uniform_int_distribution<uint64_t> distribution{ 0, n - 1 };
+  return distribution(engine);
+}
+
+// Fair coin flips, one engine bit each
+template<typename Engine>
+struct _impl_coin {
+  static_assert(Engine::min() == 0 && Engine::max() == std::numeric_limits<typename Engine::result_type>::max());
+
+  Engine& engine;
+  uint64_t bits{ 0 };
+  unsigned left{ 0 };
+
+  FORCE_INLINE bool flip() {
+    if (UNLIKELY(!left)) {
+      bits = engine();
+      left = std::numeric_limits<typename Engine::result_type>::digits;
+    }
+    const bool ret{ static_cast<bool>(bits & 1) };
+    bits >>= 1;
+    --left;
+    return ret;
+  }
+};
+
+/*
+ * Fisher-Yates over first[0, n), front to back: element i swaps with one of [0, i], so the early
+ * swaps stay within a prefix which is still in cache. With a 64-bit engine, the two indices of
+ * positions i and i + 1 come from a single draw while (i + 1) * (i + 2) fits in 64 bits
+ * (Brackett-Rozinsky and Lemire's batched ranged draws: engine() * (i + 1), then its low half * (i + 2)).
+ * Through pointers, the indices are drawn a batch ahead and prefetched, so for arrays larger than
+ * the cache the misses overlap - the swaps are still made in the same order.
+ */
+template<typename RandomIt, typename Engine>
+void _impl_fisher_yates(const RandomIt first, const size_t n, Engine& engine) {
+  using std::swap;
+  size_t i{ 1 };
+#if defined(__SIZEOF_INT128__)
+  if constexpr (Engine::min() == 0 && Engine::max() == UINT64_MAX) {
+    constexpr size_t batch{ 32 };
+    size_t targets[batch];
+    for (; i + batch <= n && i + batch <= (uint64_t{ 1 } << 32); i += batch) {
+      for (size_t k{ 0 }; k < batch; k += 2) {
+        const uint64_t a{ i + k + 1 }, b{ i + k + 2 }, product{ a * b };
+        _impl_uint128 m1{ static_cast<_impl_uint128>(engine()) * a };
+        _impl_uint128 m2{ static_cast<_impl_uint128>(static_cast<uint64_t>(m1)) * b };
+        if (UNLIKELY(static_cast<uint64_t>(m2) < product)) {
+          const uint64_t threshold{ (0 - product) % product };
+          while (static_cast<uint64_t>(m2) < threshold) {
+            m1 = static_cast<_impl_uint128>(engine()) * a;
+            m2 = static_cast<_impl_uint128>(static_cast<uint64_t>(m1)) * b;
+          }
+        }
+        targets[k] = static_cast<size_t>(m1 >> 64);
+        targets[k + 1] = static_cast<size_t>(m2 >> 64);
+        if constexpr (std::is_pointer_v<RandomIt>) {
+          PREFETCH_WRITE(first + targets[k], 3);
+          PREFETCH_WRITE(first + targets[k + 1], 3);
+        }
+      }
+      for (size_t k{ 0 }; k < batch; ++k) swap(first[i + k], first[targets[k]]);
+    }
+  }
+#endif
+  for (; i < n; ++i) swap(first[i], first[_impl_bounded(engine, i + 1)]);
+}
+
+/*
+ * MergeShuffle's merge (Bacher, Bodini, Hollender, Lumbroso): with data[lo, mid) and data[mid, hi)
+ * each uniformly shuffled, makes data[lo, hi) one - a coin flip per element while both halves
+ * last, then a Fisher-Yates style insertion of what's left of the larger one.
+ */
+template<typename RandomIt, typename Engine>
+void _impl_merge_shuffled(const RandomIt data, const size_t lo, const size_t mid, const size_t hi, Engine& engine) {
+  using std::swap;
+  _impl_coin<Engine> coin{ engine };
+  size_t i{ lo }, j{ mid };
+  for (;; ++i) {
+    if (coin.flip()) {
+      if (j == hi) break;
+      swap(data[i], data[j++]);
+    } else if (i == j) {
+      break;
+    }
+  }
+  for (; i < hi; ++i) swap(data[i], data[lo + _impl_bounded(engine, i - lo + 1)]);
+}
+
+/*
+ * Shuffles "vec" on "pool": blocks are Fisher-Yates shuffled in parallel, then merged pairwise in
+ * log2(blocks) rounds of _impl_merge_shuffled(). "engine()" returns the calling thread's engine.
+ */
+template<typename T, typename MakeEngine>
+void _impl_merge_shuffle(std::vector<T>& vec, thread_pool& pool, const size_t grain, MakeEngine&& engine) {
+  const size_t n{ vec.size() };
+  size_t blocks{ 1 };
+  while (blocks < pool.size() * 4 && n / (blocks * 2) >= grain) blocks *= 2;
+  const auto bound = [n, blocks](const size_t b) { return b * (n / blocks) + (b < n % blocks ? b : n % blocks); };
+
+  T* const data{ vec.data() };
+  pool.parallel_for(0, blocks, [&](const size_t b) {
+    auto&& e{ engine() };
+    _impl_fisher_yates(data + bound(b), bound(b + 1) - bound(b), e);
+  }, 1);
+  for (size_t width{ 1 }; width < blocks; width *= 2) {
+    pool.parallel_for(0, blocks / (width * 2), [&](const size_t pair) {
+      auto&& e{ engine() };
+      const size_t b{ pair * width * 2 };
+      _impl_merge_shuffled(data, bound(b), bound(b + width), bound(b + width * 2), e);
+    }, 1);
+  }
+}
+
+// Exp(1), as -log(u) with u uniform in (0, 1) on 53 bits. Never 0 or infinite.
+template<typename Engine>
+FORCE_INLINE double _impl_exponential(Engine& engine) {
+  static_assert(Engine::min() == 0 && Engine::max() >= UINT32_MAX);
+  uint64_t bits{ 0 };
+  if constexpr (Engine::max() == UINT64_MAX) bits = engine();
+  else bits = (static_cast<uint64_t>(engine()) << 32) | static_cast<uint32_t>(engine());
+  return -std::log((static_cast<double>(bits >> 11) + 0.5) * 0x1.0p-53);
+}
+
+/*
+ * A-ExpJ (Efraimidis-Spirakis "exponential jumps"), the same sample in one pass over a stream of
+ * unknown length. Once k items are kept, with T the largest of their keys, the next item to get
+ * a key below T comes after an Exp(T) amount of weight: that's drawn once, and the weights in
+ * between are only summed. The item which crosses it gets a key drawn below T, and replaces the
+ * item with key T. O(k log(n / k)) random draws instead of n.
+ */
+template<typename InputIt, typename WeightOf, typename Engine>
+std::vector<typename std::iterator_traits<InputIt>::value_type> _impl_weighted_sample_stream(InputIt first, const InputIt last,
+  const size_t k, WeightOf& weight_of, Engine& engine) {
+  using value_type = typename std::iterator_traits<InputIt>::value_type;
+  if (!k) return {};
+  std::vector<std::pair<double, value_type>> keyed{};
+  keyed.reserve(k);
+  const auto by_key = [](const std::pair<double, value_type>& a, const std::pair<double, value_type>& b) { return a.first < b.first; };
+
+  for (; first != last && keyed.size() < k; ++first) {
+    const double w{ static_cast<double>(weight_of(*first)) };
+    if (!(w > 0)) continue;
+    keyed.emplace_back(_impl_exponential(engine) / w, *first);
+    std::push_heap(keyed.begin(), keyed.end(), by_key);
+  }
+
+  if (first != last) {
+    double threshold{ keyed.front().first };
+    double skip{ _impl_exponential(engine) / threshold };
+    for (; first != last; ++first) {
+      const double w{ static_cast<double>(weight_of(*first)) };
+      if (!(w > 0)) continue;
+      skip -= w;
+      if (skip > 0) continue;
+      // E conditioned on E / w < threshold, by inversion: -log(1 - u * (1 - exp(-w * threshold)))
+      const double u{ (static_cast<double>(_impl_bounded(engine, uint64_t{ 1 } << 53)) + 0.5) * 0x1.0p-53 };
+      const double key{ -std::log1p(u * std::expm1(-w * threshold)) / w };
+      std::pop_heap(keyed.begin(), keyed.end(), by_key);
+      keyed.back() = { key, *first };
+      std::push_heap(keyed.begin(), keyed.end(), by_key);
+      threshold = keyed.front().first;
+      skip = _impl_exponential(engine) / threshold;
+    }
+  }
+
+  std::sort(keyed.begin(), keyed.end(), by_key);
+  std::vector<value_type> ret{};
+  ret.reserve(keyed.size());
+  for (std::pair<double, value_type>& entry : keyed) ret.push_back(std::move(entry.second));
+  return ret;
+}
+
+// Positions 0, 1, ... as an input iterator, to run the streaming sampler over an indexable range
+struct _impl_index_iterator {
+  using iterator_category = std::input_iterator_tag;
+  using value_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const size_t*;
+  using reference = size_t;
+
+  size_t index;
+
+  size_t operator*() const noexcept { return index; }
+  _impl_index_iterator& operator++() noexcept {
+    ++index;
+    return *this;
+  }
+  friend bool operator==(const _impl_index_iterator& a, const _impl_index_iterator& b) noexcept { return a.index == b.index; }
+  friend bool operator!=(const _impl_index_iterator& a, const _impl_index_iterator& b) noexcept { return a.index != b.index; }
+};
+
+// Up to this many candidates per pick, a key for every candidate and std::nth_element beat the
+// jumps, which by then replace kept items almost as often as they skip
+inline constexpr size_t _impl_weighted_select_ratio{ 8 };
+
+/*
+ * Efraimidis-Spirakis: index i gets the key E_i / w_i, E_i ~ Exp(1), and the k smallest keys win.
+ * Sorted by key, they're distributed as k successive weighted draws without replacement.
+ * With few picks per candidate, the exponential jumps below find the same sample in a bounded heap
+ * without drawing a key (a log()) per candidate; otherwise every key is drawn and std::nth_element
+ * selects. Weights which aren't > 0 (incl. NaN) never win.
+ */
+template<typename Weights, typename Engine>
+std::vector<size_t> _impl_weighted_sample(const Weights& weights, const size_t k, Engine& engine) {
+  const size_t n{ static_cast<size_t>(std::size(weights)) };
+  if (!n || !k) return {};
+  if (k <= n / _impl_weighted_select_ratio) {
+    const auto weight_of = [&weights](const size_t i) { return weights[i]; };
+    return _impl_weighted_sample_stream(_impl_index_iterator{ 0 }, _impl_index_iterator{ n }, k, weight_of, engine);
+  }
+
+  std::vector<std::pair<double, size_t>> keyed{};
+  keyed.reserve(n);
+  for (size_t i{ 0 }; i < n; ++i) {
+    const double w{ static_cast<double>(weights[i]) };
+    if (w > 0) keyed.emplace_back(_impl_exponential(engine) / w, i);
+  }
+  if (keyed.size() > k) {
+    std::nth_element(keyed.begin(), keyed.begin() + static_cast<std::ptrdiff_t>(k), keyed.end());
+    keyed.resize(k);
+  }
+  std::sort(keyed.begin(), keyed.end());
+  std::vector<size_t> ret(keyed.size());
+  for (size_t j{ 0 }; j < keyed.size(); ++j) ret[j] = keyed[j].second;
+  return ret;
+}
+} // namespace detail
+
+/*
+ * "n" values computed on demand, one fn(i) per pick: "random(generated(n, fn))" picks from
+ * { fn(0), ..., fn(n - 1) } without storing it - the C++17 spelling of
+ * std::views::iota(size_t{ 0 }, n) | std::views::transform(fn).
+ */
+template<typename Fn>
+struct generated_range {
+  size_t count;
+  Fn fn;
+
+  size_t size() const noexcept { return count; }
+  decltype(auto) operator[](const size_t i) const { return fn(i); }
+}; // struct generated_range
+
+template<typename Fn>
+generated_range<Fn> generated(const size_t n, Fn fn) { return { n, std::move(fn) }; }
+
 class random_prng {
 public:
   // Since a "random_prng" object can't even be initialized, copy / move is by default blocked.
@@ -39,10 +424,21 @@ public:
    * @return T A copy value randomly picked from the given vector
    */
   template<typename T>
-  static T random(const std::vector<T>& vec) {
-    if (vec.empty()) return {};
-    std::uniform_int_distribution<size_t> distribution{ 0, vec.size() - 1 };
-    return vec[distribution(_impl_prng_engine())];
+  HOT static T random(const std::vector<T>& vec) {
+    SELENA_TIME(prng_random);
+    if (UNLIKELY(vec.empty())) return {};
+    return vec[random_index(vec.size())];
+  }
+
+  /*
+   * Usage: "random_index(n)" - the draw random(vec) makes, without a container.
+   * @param n Number of possible values
+   * @returns size_t Uniform in [0, n). 0 if n is 0.
+   */
+  HOT static size_t random_index(const size_t n) {
+    if (UNLIKELY(!n)) return 0;
+    std::uniform_int_distribution<size_t> distribution{ 0, n - 1 };
+    return distribution(_impl_prng_engine());
   }
 
   /*
@@ -53,17 +449,47 @@ public:
    */
   template<typename T>
   static std::vector<T> random(const std::vector<T>& vec, const size_t count) {
-    if (vec.empty()) return {};
-    if (!count) return {};
-    if (count == 1) return { random(vec) };
-
     std::vector<T> ret_vec{};
-    ret_vec.reserve(count);
+    _impl_random_into(vec, count, ret_vec);
+    return ret_vec;
+  }
 
-    std::uniform_int_distribution<size_t> distribution{ 0, vec.size() - 1 };
-    std::mt19937_64& engine{ _impl_prng_engine() };
+  /*
+   * Usage "random(vec, x, arena.resource())"
+   * Same as above, but the returned vector allocates from "resource", ex. a selena::arena.
+   * @param vec A reference to a std::vector obj.
+   * @param count A size_t number specifying the number of elements to be generated
+   * @param resource Where the returned vector's buffer comes from
+   * @returns std::pmr::vector<T> A std::pmr::vector<T> object
+   */
+  template<typename T>
+  static std::pmr::vector<T> random(const std::vector<T>& vec, const size_t count, std::pmr::memory_resource* const resource) {
+    std::pmr::vector<T> ret_vec{ resource };
+    _impl_random_into(vec, count, ret_vec);
+    return ret_vec;
+  }
 
-    for (size_t i{ 0 }; i < count; ++i) ret_vec.push_back(vec[distribution(engine)]);
+  /*
+   * Usage "random(vec, x, pool)"
+   * Same as above, but the picks are drawn on the workers of "pool", each with its own engine.
+   * Worth it from some 10^5 picks on. T has to be default constructible.
+   * @param vec A reference to a std::vector obj.
+   * @param count A size_t number specifying the number of elements to be generated
+   * @param pool The selena::thread_pool to run on
+   * @returns std::vector<T> A std::vector<T> object
+   */
+  template<typename T>
+  static std::vector<T> random(const std::vector<T>& vec, const size_t count, thread_pool& pool) {
+    static_assert(!std::is_same_v<T, bool>, "std::vector<bool> can't be written from several threads");
+    if (vec.empty()) return {};
+    if (!count) return {};
+    SELENA_TIME(prng_random);
+
+    std::vector<T> ret_vec(count);
+    pool.parallel_for(0, count, [&vec, &ret_vec](const size_t begin, const size_t end) {
+      T* out{ ret_vec.data() + begin };
+      _impl_draw(vec, end - begin, [&out](const T& value) { *out++ = value; });
+    }, parallel_grain);
     return ret_vec;
   }
 
@@ -73,7 +499,8 @@ public:
    * @returns T A copy value randomly picked from the given array
    */
   template<typename T, size_t N>
-  static T random(const std::array<T, N>& arr) {
+  HOT static T random(const std::array<T, N>& arr) {
+    SELENA_TIME(prng_random);
     if (arr.empty()) return {};
     std::uniform_int_distribution<size_t> distribution{ 0, arr.size() - 1 };
     return arr[distribution(_impl_prng_engine())];
@@ -88,6 +515,7 @@ public:
   static std::array<T, Count> random(const std::array<T, N>& arr) {
     if (arr.empty()) return {};
     if constexpr (!Count) return {};
+    SELENA_TIME(prng_random);
 
     std::array<T, Count> ret_arr{};
     std::uniform_int_distribution<size_t> distribution{ 0, arr.size() - 1 };
@@ -97,8 +525,250 @@ public:
     return ret_arr;
   }
 
+  /*
+   * Usage: "random(range)", for whatever isn't a std::vector / std::array but has std::size() and
+   * operator[] - ex. a std::deque, std::views::iota(0, n) or generated(n, fn). Only the picked
+   * element is read (or computed), so lazy ranges are never materialized.
+   * @param range The range
+   * @returns The picked element, by value. Value-initialized if "range" is empty.
+   */
+  template<typename Range, std::enable_if_t<detail::_impl_is_indexable<Range>::value, int> = 0>
+  HOT static detail::_impl_indexed_t<Range> random(const Range& range) {
+    SELENA_TIME(prng_random);
+    const size_t size{ static_cast<size_t>(std::size(range)) };
+    if (UNLIKELY(!size)) return {};
+    return range[random_index(size)];
+  }
+
+  /*
+   * Usage: "random(range, x)" - as above, "count" times. O(count), whatever the size of "range".
+   * @param range The range
+   * @param count Number of picks
+   * @returns std::vector A std::vector of the picked elements
+   */
+  template<typename Range, std::enable_if_t<detail::_impl_is_indexable<Range>::value, int> = 0>
+  static std::vector<detail::_impl_indexed_t<Range>> random(const Range& range, const size_t count) {
+    const size_t size{ static_cast<size_t>(std::size(range)) };
+    if (!size) return {};
+    if (!count) return {};
+    SELENA_TIME(prng_random);
+
+    std::vector<detail::_impl_indexed_t<Range>> ret_vec{};
+    ret_vec.reserve(count);
+    std::uniform_int_distribution<size_t> distribution{ 0, size - 1 };
+    std::mt19937_64& engine{ _impl_prng_engine() };
+    for (size_t i{ 0 }; i < count; ++i) ret_vec.push_back(range[distribution(engine)]);
+    return ret_vec;
+  }
+
+  /*
+   * Usage: "random_in(1, 6)" - an integer from [lo, hi], both included. Any integer type.
+   * @param lo Smallest value
+   * @param hi Largest value
+   * @returns T Uniform in [lo, hi]. "lo" if hi < lo.
+   */
+  template<typename T>
+  HOT static T random_in(const T lo, const T hi) {
+    SELENA_TIME(prng_random);
+    if (UNLIKELY(hi < lo)) return lo;
+    const detail::_impl_interval<T> interval{ lo, hi };
+    std::uniform_int_distribution<uint64_t> distribution{ 0, interval.span };
+    return interval.at(distribution(_impl_prng_engine()));
+  }
+
+  /*
+   * Usage: "random_in(0ull, 999'999'999ull, x)" - "count" picks from [lo, hi], as random(vec, x)
+   * would make from a vector holding all of it, but without one: O(count) time and memory.
+   * @param lo Smallest value
+   * @param hi Largest value
+   * @param count Number of picks
+   * @returns std::vector<T> A std::vector<T> object, empty if hi < lo
+   */
+  template<typename T>
+  static std::vector<T> random_in(const T lo, const T hi, const size_t count) {
+    if (hi < lo) return {};
+    if (!count) return {};
+    SELENA_TIME(prng_random);
+
+    std::vector<T> ret_vec(count);
+    const detail::_impl_interval<T> interval{ lo, hi };
+    std::uniform_int_distribution<uint64_t> distribution{ 0, interval.span };
+    std::mt19937_64& engine{ _impl_prng_engine() };
+    for (T& value : ret_vec) value = interval.at(distribution(engine));
+    return ret_vec;
+  }
+
+  /*
+   * Usage: "shuffle(vec.begin(), vec.end())" - Fisher-Yates, as std::shuffle, but each index
+   * takes one engine call and a multiply (Lemire) instead of a distribution's division.
+   * @param first, last Random access iterators
+   */
+  template<typename RandomIt>
+  static void shuffle(const RandomIt first, const RandomIt last) {
+    SELENA_TIME(prng_random);
+    if (last - first < 2) return;
+    detail::_impl_fisher_yates(first, static_cast<size_t>(last - first), _impl_prng_engine());
+  }
+
+  // Usage: "shuffle(vec)"
+  template<typename T>
+  static void shuffle(std::vector<T>& vec) {
+    if constexpr (std::is_same_v<T, bool>) shuffle(vec.begin(), vec.end());
+    else shuffle(vec.data(), vec.data() + vec.size()); // Through pointers, which can be prefetched
+  }
+
+  /*
+   * Usage: "shuffle(vec, pool)" - MergeShuffle: blocks shuffled on the workers of "pool", each
+   * with its own engine, then merged pairwise (in parallel, but for the last merge) with one
+   * coin flip per element. Still uniform. Worth it from some 10^6 elements on.
+   * @param vec A reference to a std::vector obj.
+   * @param pool The selena::thread_pool to run on
+   */
+  template<typename T>
+  static void shuffle(std::vector<T>& vec, thread_pool& pool) {
+    static_assert(!std::is_same_v<T, bool>, "std::vector<bool> can't be written from several threads");
+    if (vec.size() < shuffle_grain * 2) {
+      shuffle(vec);
+      return;
+    }
+    SELENA_TIME(prng_random);
+    detail::_impl_merge_shuffle(vec, pool, shuffle_grain, []() -> std::mt19937_64& { return _impl_prng_engine(); });
+  }
+
+  /*
+   * Usage: "weighted_sample(weights, k)", ex. k distinct backends by capacity.
+   * Efraimidis-Spirakis: every index gets an exponential key scaled by its weight and the k best
+   * win - found with exponential jumps over a bounded heap when k is small next to the candidates,
+   * with std::nth_element over all keys otherwise. O(n + k log k log(n / k)) at worst, instead of
+   * O(n * k) for k weighted picks with removal.
+   * @param weights Weights, of any arithmetic type. Indices whose weight isn't > 0 are never picked.
+   * @param k Number of picks
+   * @returns std::vector<size_t> min(k, positive weights) distinct indices, in the order k weighted
+   *          draws without replacement would have made them
+   */
+  template<typename W>
+  static std::vector<size_t> weighted_sample(const std::vector<W>& weights, const size_t k) {
+    static_assert(std::is_arithmetic_v<W>, "Weights have to be numbers");
+    SELENA_TIME(prng_random);
+    return detail::_impl_weighted_sample(weights, k, _impl_prng_engine());
+  }
+
+  /*
+   * Usage: "weighted_sample(first, last, k, weight_of)" - as above, in a single pass over items of
+   * unknown number (A-ExpJ): only the kept items are stored, and after the first k, random draws
+   * are only made each time the sample changes - O(k log(n / k)) of them, not n.
+   * @param first, last Input iterators
+   * @param k Number of picks
+   * @param weight_of Called once per item as weight_of(item), returns its weight
+   * @returns std::vector A std::vector of copies of the picked items, in draw order
+   */
+  template<typename InputIt, typename WeightOf>
+  static std::vector<typename std::iterator_traits<InputIt>::value_type> weighted_sample(const InputIt first, const InputIt last,
+    const size_t k, WeightOf&& weight_of) {
+    SELENA_TIME(prng_random);
+    return detail::_impl_weighted_sample_stream(first, last, k, weight_of, _impl_prng_engine());
+  }
+
+  /*
+   * Usage: "random_string("0123456789abcdef", 32)", ex. for test keys.
+   * Draws 64 bits at a time and maps them to the alphabet, see random_string_into().
+   * @param alphabet The characters to pick from. Repeating one makes it proportionally likelier.
+   * @param length Number of characters
+   * @returns std::string "length" characters, empty if the alphabet is empty
+   */
+  static std::string random_string(const std::string_view alphabet, const size_t length) {
+    if (alphabet.empty()) return {};
+    std::string ret(length, '\0');
+    random_string_into(alphabet, ret.data(), length);
+    return ret;
+  }
+
+  /*
+   * Same as random_string(), but writes into a caller-provided buffer - nothing is allocated.
+   * Alphabets with a power of two size (hex, base64url, ...) use every random bit; for the others,
+   * bytes which would bias the result are rejected.
+   * @param alphabet The characters to pick from
+   * @param dest Where to write, at least "length" chars. Not null-terminated. Left untouched if the alphabet is empty.
+   * @param length Number of characters
+   */
+  HOT static void random_string_into(const std::string_view alphabet, char* const dest, const size_t length) {
+    SELENA_TIME(prng_random);
+    std::mt19937_64& engine{ _impl_prng_engine() };
+    detail::_impl_random_string(alphabet, dest, length, [&engine](uint64_t* const words, const size_t count) {
+      for (size_t i{ 0 }; i < count; ++i) words[i] = engine();
+    });
+  }
+
+  /*
+   * Fills a buffer with random bytes, 8 per engine call. Usage: "random_bytes(&key, sizeof(key));"
+   * @param dest Where to write
+   * @param count Number of bytes
+   */
+  HOT static void random_bytes(void* const dest, const size_t count) {
+    SELENA_TIME(prng_random);
+    std::mt19937_64& engine{ _impl_prng_engine() };
+    unsigned char* out{ static_cast<unsigned char*>(dest) };
+    size_t left{ count };
+    for (; left >= 8; left -= 8, out += 8) {
+      const uint64_t word{ engine() };
+      std::memcpy(out, &word, 8);
+    }
+    if (left) {
+      const uint64_t word{ engine() };
+      std::memcpy(out, &word, left);
+    }
+  }
+
 private:
-  static inline std::mt19937_64& _impl_prng_engine() {
+  // Smallest number of picks a worker takes at once in random(vec, count, pool)
+  static constexpr size_t parallel_grain{ 4096 };
+  // Smallest block shuffle(vec, pool) hands a worker
+  static constexpr size_t shuffle_grain{ size_t{ 1 } << 16 };
+
+  // Appends "count" picks to "out", a std::vector or a std::pmr::vector
+  template<typename T, typename Vec>
+  static void _impl_random_into(const std::vector<T>& vec, const size_t count, Vec& out) {
+    if (vec.empty()) return;
+    if (!count) return;
+    if (count == 1) {
+      out.push_back(random(vec));
+      return;
+    }
+    SELENA_TIME(prng_random);
+
+    out.reserve(count);
+    _impl_draw(vec, count, [&out](const T& value) { out.push_back(value); });
+  }
+
+  // Hands "count" picks from this thread's engine to "sink"
+  template<typename T, typename Sink>
+  static void _impl_draw(const std::vector<T>& vec, const size_t count, Sink&& sink) {
+    std::uniform_int_distribution<size_t> distribution{ 0, vec.size() - 1 };
+    std::mt19937_64& engine{ _impl_prng_engine() };
+
+    // Indices are drawn "lookahead" picks in advance and their elements prefetched, so for
+    // vectors larger than the cache the misses overlap instead of being paid one by one.
+    // The engine is still consumed in the same order, so the output is the same as without it.
+    constexpr size_t lookahead{ 8 };
+    size_t pending[lookahead];
+    const size_t primed{ count < lookahead ? count : lookahead };
+    for (size_t i{ 0 }; i < primed; ++i) {
+      pending[i] = distribution(engine);
+      PREFETCH_READ(vec.data() + pending[i], 3);
+    }
+
+    for (size_t i{ 0 }; i < count; ++i) {
+      const size_t slot{ i % lookahead };
+      const size_t index{ pending[slot] };
+      if (LIKELY(i + lookahead < count)) {
+        pending[slot] = distribution(engine);
+        PREFETCH_READ(vec.data() + pending[slot], 3);
+      }
+      sink(vec[index]);
+    }
+  }
+
+  FORCE_INLINE static std::mt19937_64& _impl_prng_engine() {
     static thread_local std::random_device random_device_seed{};
     static thread_local std::mt19937_64 generator{ random_device_seed() };
     return generator;
@@ -130,9 +800,21 @@ public:
    */
   template<typename T>
   static T random(const std::vector<T>& vec) {
+    SELENA_TIME(trng_random);
     if (vec.empty()) return {};
-    std::uniform_int_distribution<size_t> distribution{ 0, vec.size() - 1 };
-    return vec[distribution(_impl_trng_engine())];
+    return vec[random_index(vec.size())];
+  }
+
+  /*
+   * Usage: "random_index(n)" - the draw random(vec) makes, without a container.
+   * @param n Number of possible values
+   * @returns size_t Uniform in [0, n). 0 if n is 0.
+   */
+  static size_t random_index(const size_t n) {
+    if (!n) return 0;
+    std::uniform_int_distribution<size_t> distribution{ 0, n - 1 };
+    _impl_counted_device engine{ _impl_trng_engine() };
+    return distribution(engine);
   }
 
   /*
@@ -143,17 +825,48 @@ public:
    */
   template<typename T>
   static std::vector<T> random(const std::vector<T>& vec, const size_t count) {
-    if (vec.empty()) return {};
-    if (!count) return {};
-    if (count == 1) return { random(vec) };
-
     std::vector<T> ret_vec{};
-    ret_vec.reserve(count);
+    _impl_random_into(vec, count, ret_vec);
+    return ret_vec;
+  }
 
-    std::uniform_int_distribution<size_t> distribution{ 0, vec.size() - 1 };
-    std::random_device& engine{ _impl_trng_engine() };
+  /*
+   * Usage "random(vec, x, arena.resource())"
+   * Same as above, but the returned vector allocates from "resource", ex. a selena::arena.
+   * @param vec A reference to a std::vector obj.
+   * @param count A size_t number specifying the number of elements to be generated
+   * @param resource Where the returned vector's buffer comes from
+   * @returns std::pmr::vector<T> A std::pmr::vector<T> object
+   */
+  template<typename T>
+  static std::pmr::vector<T> random(const std::vector<T>& vec, const size_t count, std::pmr::memory_resource* const resource) {
+    std::pmr::vector<T> ret_vec{ resource };
+    _impl_random_into(vec, count, ret_vec);
+    return ret_vec;
+  }
+
+  /*
+   * Usage "random(vec, x, pool)"
+   * Same as above, but the picks are drawn on the workers of "pool", each from its own device.
+   * T has to be default constructible.
+   * @param vec A reference to a std::vector obj.
+   * @param count A size_t number specifying the number of elements to be generated
+   * @param pool The selena::thread_pool to run on
+   * @returns std::vector<T> A std::vector<T> object
+   */
+  template<typename T>
+  static std::vector<T> random(const std::vector<T>& vec, const size_t count, thread_pool& pool) {
+    static_assert(!std::is_same_v<T, bool>, "std::vector<bool> can't be written from several threads");
+    if (vec.empty()) return {};
+    if (!count) return {};
+    SELENA_TIME(trng_random);
 
-    for (size_t i{ 0 }; i < count; ++i) ret_vec.push_back(vec[distribution(engine)]);
+    std::vector<T> ret_vec(count);
+    pool.parallel_for(0, count, [&vec, &ret_vec](const size_t begin, const size_t end) {
+      std::uniform_int_distribution<size_t> distribution{ 0, vec.size() - 1 };
+      _impl_counted_device engine{ _impl_trng_engine() };
+      for (size_t i{ begin }; i < end; ++i) ret_vec[i] = vec[distribution(engine)];
+    }, parallel_grain);
     return ret_vec;
   }
 
@@ -164,9 +877,11 @@ public:
    */
   template<typename T, size_t N>
   static T random(const std::array<T, N>& arr) {
+    SELENA_TIME(trng_random);
     if (arr.empty()) return {};
     std::uniform_int_distribution<size_t> distribution{ 0, arr.size() - 1 };
-    return arr[distribution(_impl_trng_engine())];
+    _impl_counted_device engine{ _impl_trng_engine() };
+    return arr[distribution(engine)];
   }
 
   /*
@@ -178,20 +893,256 @@ public:
   static std::array<T, Count> random(const std::array<T, N>& arr) {
     if (arr.empty()) return {};
     if constexpr (!Count) return {};
+    SELENA_TIME(trng_random);
 
     std::array<T, Count> ret_arr{};
     std::uniform_int_distribution<size_t> distribution{ 0, arr.size() - 1 };
-    std::random_device& engine{ _impl_trng_engine() };
+    _impl_counted_device engine{ _impl_trng_engine() };
 
     for (size_t i{ 0 }; i < Count; ++i) ret_arr[i] = arr[distribution(engine)];
     return ret_arr;
   }
 
+  /*
+   * Usage: "random(range)" - see random_prng::random(range).
+   * @param range Anything with std::size() and operator[], ex. std::views::iota(0, n) or generated(n, fn)
+   * @returns The picked element, by value. Value-initialized if "range" is empty.
+   */
+  template<typename Range, std::enable_if_t<detail::_impl_is_indexable<Range>::value, int> = 0>
+  static detail::_impl_indexed_t<Range> random(const Range& range) {
+    SELENA_TIME(trng_random);
+    const size_t size{ static_cast<size_t>(std::size(range)) };
+    if (!size) return {};
+    return range[random_index(size)];
+  }
+
+  /*
+   * Usage: "random(range, x)" - as above, "count" times. O(count), whatever the size of "range".
+   * @param range The range
+   * @param count Number of picks
+   * @returns std::vector A std::vector of the picked elements
+   */
+  template<typename Range, std::enable_if_t<detail::_impl_is_indexable<Range>::value, int> = 0>
+  static std::vector<detail::_impl_indexed_t<Range>> random(const Range& range, const size_t count) {
+    const size_t size{ static_cast<size_t>(std::size(range)) };
+    if (!size) return {};
+    if (!count) return {};
+    SELENA_TIME(trng_random);
+
+    std::vector<detail::_impl_indexed_t<Range>> ret_vec{};
+    ret_vec.reserve(count);
+    std::uniform_int_distribution<size_t> distribution{ 0, size - 1 };
+    _impl_counted_device engine{ _impl_trng_engine() };
+    for (size_t i{ 0 }; i < count; ++i) ret_vec.push_back(range[distribution(engine)]);
+    return ret_vec;
+  }
+
+  /*
+   * Usage: "random_in(1, 6)" - an integer from [lo, hi], both included. Any integer type.
+   * @param lo Smallest value
+   * @param hi Largest value
+   * @returns T Uniform in [lo, hi]. "lo" if hi < lo.
+   */
+  template<typename T>
+  static T random_in(const T lo, const T hi) {
+    SELENA_TIME(trng_random);
+    if (hi < lo) return lo;
+    const detail::_impl_interval<T> interval{ lo, hi };
+    std::uniform_int_distribution<uint64_t> distribution{ 0, interval.span };
+    _impl_counted_device engine{ _impl_trng_engine() };
+    return interval.at(distribution(engine));
+  }
+
+  /*
+   * Usage: "random_in(lo, hi, x)" - "count" picks from [lo, hi] without materializing it, see
+   * random_prng::random_in().
+   * @param lo Smallest value
+   * @param hi Largest value
+   * @param count Number of picks
+   * @returns std::vector<T> A std::vector<T> object, empty if hi < lo
+   */
+  template<typename T>
+  static std::vector<T> random_in(const T lo, const T hi, const size_t count) {
+    if (hi < lo) return {};
+    if (!count) return {};
+    SELENA_TIME(trng_random);
+
+    std::vector<T> ret_vec(count);
+    const detail::_impl_interval<T> interval{ lo, hi };
+    std::uniform_int_distribution<uint64_t> distribution{ 0, interval.span };
+    _impl_counted_device engine{ _impl_trng_engine() };
+    for (T& value : ret_vec) value = interval.at(distribution(engine));
+    return ret_vec;
+  }
+
+  /*
+   * Usage: "shuffle(vec.begin(), vec.end())" - Fisher-Yates, one device read per element.
+   * @param first, last Random access iterators
+   */
+  template<typename RandomIt>
+  static void shuffle(const RandomIt first, const RandomIt last) {
+    SELENA_TIME(trng_random);
+    if (last - first < 2) return;
+    _impl_counted_device engine{ _impl_trng_engine() };
+    detail::_impl_fisher_yates(first, static_cast<size_t>(last - first), engine);
+  }
+
+  // Usage: "shuffle(vec)"
+  template<typename T>
+  static void shuffle(std::vector<T>& vec) {
+    if constexpr (std::is_same_v<T, bool>) shuffle(vec.begin(), vec.end());
+    else shuffle(vec.data(), vec.data() + vec.size()); // Through pointers, which can be prefetched
+  }
+
+  /*
+   * Usage: "shuffle(vec, pool)" - see random_prng::shuffle(vec, pool). The merges take one device
+   * read per 32 elements rather than one per element.
+   * @param vec A reference to a std::vector obj.
+   * @param pool The selena::thread_pool to run on
+   */
+  template<typename T>
+  static void shuffle(std::vector<T>& vec, thread_pool& pool) {
+    static_assert(!std::is_same_v<T, bool>, "std::vector<bool> can't be written from several threads");
+    if (vec.size() < shuffle_grain * 2) {
+      shuffle(vec);
+      return;
+    }
+    SELENA_TIME(trng_random);
+    detail::_impl_merge_shuffle(vec, pool, shuffle_grain, []() { return _impl_counted_device{ _impl_trng_engine() }; });
+  }
+
+  /*
+   * Usage: "weighted_sample(weights, k)" - see random_prng::weighted_sample(weights, k).
+   * Takes two device reads per positive weight.
+   * @param weights Weights, of any arithmetic type. Indices whose weight isn't > 0 are never picked.
+   * @param k Number of picks
+   * @returns std::vector<size_t> min(k, positive weights) distinct indices, in draw order
+   */
+  template<typename W>
+  static std::vector<size_t> weighted_sample(const std::vector<W>& weights, const size_t k) {
+    static_assert(std::is_arithmetic_v<W>, "Weights have to be numbers");
+    SELENA_TIME(trng_random);
+    _impl_counted_device engine{ _impl_trng_engine() };
+    return detail::_impl_weighted_sample(weights, k, engine);
+  }
+
+  /*
+   * Usage: "weighted_sample(first, last, k, weight_of)" - see random_prng::weighted_sample(first, last, k, weight_of).
+   * @param first, last Input iterators
+   * @param k Number of picks
+   * @param weight_of Called once per item as weight_of(item), returns its weight
+   * @returns std::vector A std::vector of copies of the picked items, in draw order
+   */
+  template<typename InputIt, typename WeightOf>
+  static std::vector<typename std::iterator_traits<InputIt>::value_type> weighted_sample(const InputIt first, const InputIt last,
+    const size_t k, WeightOf&& weight_of) {
+    SELENA_TIME(trng_random);
+    _impl_counted_device engine{ _impl_trng_engine() };
+    return detail::_impl_weighted_sample_stream(first, last, k, weight_of, engine);
+  }
+
+  /*
+   * Usage: "random_string(alphabet, 32)", ex. for session tokens.
+   * Unlike the other functions here, the entropy is read in bulk: one getrandom() call per batch
+   * of up to 64 words on Linux (a whole token, unless it's a long one), instead of one read per character.
+   * @param alphabet The characters to pick from. Repeating one makes it proportionally likelier.
+   * @param length Number of characters
+   * @returns std::string "length" characters, empty if the alphabet is empty
+   */
+  static std::string random_string(const std::string_view alphabet, const size_t length) {
+    if (alphabet.empty()) return {};
+    std::string ret(length, '\0');
+    random_string_into(alphabet, ret.data(), length);
+    return ret;
+  }
+
+  /*
+   * Same as random_string(), but writes into a caller-provided buffer - nothing is allocated.
+   * See random_prng::random_string_into() for how bits are mapped to the alphabet.
+   * @param alphabet The characters to pick from
+   * @param dest Where to write, at least "length" chars. Not null-terminated. Left untouched if the alphabet is empty.
+   * @param length Number of characters
+   */
+  static void random_string_into(const std::string_view alphabet, char* const dest, const size_t length) {
+    SELENA_TIME(trng_random);
+    detail::_impl_random_string(alphabet, dest, length, [](uint64_t* const words, const size_t count) {
+      _impl_fill_entropy(words, count * sizeof(uint64_t));
+    });
+  }
+
+  /*
+   * Fills a buffer with bytes from the OS's entropy pool - in a single read on Linux, for up to 256 bytes.
+   * @param dest Where to write
+   * @param count Number of bytes
+   */
+  static void random_bytes(void* const dest, const size_t count) {
+    SELENA_TIME(trng_random);
+    _impl_fill_entropy(dest, count);
+  }
+
 private:
-  static inline std::random_device& _impl_trng_engine() {
+  // Smallest number of picks a worker takes at once in random(vec, count, pool)
+  static constexpr size_t parallel_grain{ 256 };
+  // Smallest block shuffle(vec, pool) hands a worker
+  static constexpr size_t shuffle_grain{ size_t{ 1 } << 12 };
+
+  // Appends "count" picks to "out", a std::vector or a std::pmr::vector
+  template<typename T, typename Vec>
+  static void _impl_random_into(const std::vector<T>& vec, const size_t count, Vec& out) {
+    if (vec.empty()) return;
+    if (!count) return;
+    if (count == 1) {
+      out.push_back(random(vec));
+      return;
+    }
+    SELENA_TIME(trng_random);
+
+    out.reserve(count);
+
+    std::uniform_int_distribution<size_t> distribution{ 0, vec.size() - 1 };
+    _impl_counted_device engine{ _impl_trng_engine() };
+
+    for (size_t i{ 0 }; i < count; ++i) out.push_back(vec[distribution(engine)]);
+  }
+
+  // Forwards to the std::random_device, counting every read for SELENA_INSTRUMENT builds.
+  // Compiles down to the plain device otherwise.
+  struct _impl_counted_device {
+    using result_type = std::random_device::result_type;
+    static constexpr result_type min() { return std::random_device::min(); }
+    static constexpr result_type max() { return std::random_device::max(); }
+    result_type operator()() {
+      SELENA_COUNT(trng_entropy_reads, 1);
+      return device();
+    }
+    std::random_device& device;
+  };
+
+  FORCE_INLINE static std::random_device& _impl_trng_engine() {
     static thread_local std::random_device device{};
     return device;
   }
+
+  // Fills "bytes" bytes from the OS's entropy pool, with as few reads as possible
+  static void _impl_fill_entropy(void* const dest, size_t bytes) {
+    unsigned char* out{ static_cast<unsigned char*>(dest) };
+#if defined(__linux__) && __has_include(<sys/random.h>)
+    while (bytes) {
+      SELENA_COUNT(trng_entropy_reads, 1);
+      const ssize_t n{ ::getrandom(out, bytes, 0) };
+      if (n <= 0) break; // EINTR, or ENOSYS before 3.17: the device below takes over
+      out += n;
+      bytes -= static_cast<size_t>(n);
+    }
+#endif // __linux__
+    _impl_counted_device engine{ _impl_trng_engine() };
+    for (; bytes; out += 4) {
+      const uint32_t value{ static_cast<uint32_t>(engine()) };
+      const size_t n{ bytes < 4 ? bytes : 4 };
+      std::memcpy(out, &value, n);
+      bytes -= n;
+    }
+  }
 }; // class "random_trng"
 } // namespace selena
 
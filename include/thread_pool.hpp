@@ -0,0 +1,492 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_THREAD_POOL_HPP
+#define SELENA_THREAD_POOL_HPP
+
+// Work-stealing thread pool, the executor behind selena's bulk overloads (random(vec, count, pool),
+// is_valid_url(urls, pool), ...).
+// Every worker owns a Chase-Lev deque: it pushes and pops at the bottom without contention, idle
+// workers steal from the top - the oldest, i.e. biggest, piece of work. Workers on the same NUMA
+// node are tried first. Work from outside the pool goes through a small locked injection queue.
+// parallel_for() splits lazily: a worker only halves its range while its own deque is empty, i.e.
+// when the previous half has been stolen. With no idle workers around, a range is never split
+// further than needed, so the chunking adapts to the load instead of being fixed up front.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef __linux__
+  #include <sched.h>
+#endif // __linux__
+
+#include "base.hpp"
+#include "pool.hpp"
+
+namespace selena {
+struct thread_pool_options {
+  size_t threads{ 0 }; // Number of workers. 0 means one per CPU the process is allowed to run on.
+  bool pin{ false };   // Pin every worker to one CPU, filling a NUMA node before moving to the next (Linux)
+};
+
+class thread_pool;
+
+namespace detail {
+struct _impl_task {
+  void (*run)(_impl_task*);
+};
+
+// Chase & Lev, "Dynamic Circular Work-Stealing Deque", with the C11 orderings from Lê et al.,
+// "Correct and Efficient Work-Stealing for Weak Memory Models". Fixed size: when full, push()
+// fails and the caller runs the task itself.
+class _impl_ws_deque {
+public:
+  static constexpr int64_t capacity{ 1 << 10 };
+
+  // Owner only
+  bool push(_impl_task* const task) noexcept {
+    const int64_t b{ _bottom.load(std::memory_order_relaxed) };
+    const int64_t t{ _top.load(std::memory_order_acquire) };
+    if (b - t >= capacity) return false;
+    _buffer[b & (capacity - 1)].store(task, std::memory_order_relaxed);
+    _bottom.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Owner only
+  _impl_task* pop() noexcept {
+    const int64_t b{ _bottom.load(std::memory_order_relaxed) - 1 };
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t{ _top.load(std::memory_order_relaxed) };
+    if (t > b) {
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    _impl_task* task{ _buffer[b & (capacity - 1)].load(std::memory_order_relaxed) };
+    if (t == b) { // Last one, race the thieves for it
+      if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) task = nullptr;
+      _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  // Any thread
+  _impl_task* steal() noexcept {
+    int64_t t{ _top.load(std::memory_order_acquire) };
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b{ _bottom.load(std::memory_order_acquire) };
+    if (t >= b) return nullptr;
+    _impl_task* const task{ _buffer[t & (capacity - 1)].load(std::memory_order_relaxed) };
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+    return task;
+  }
+
+  // A hint, exact only for the owner
+  [[nodiscard]] bool empty() const noexcept {
+    return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+  }
+
+private:
+  CACHELINE_ALIGNED std::atomic<int64_t> _top{ 0 };
+  CACHELINE_ALIGNED std::atomic<int64_t> _bottom{ 0 };
+  CACHELINE_ALIGNED std::atomic<_impl_task*> _buffer[capacity]{};
+};
+
+struct _impl_worker {
+  _impl_ws_deque deque{};
+  thread_pool* pool{ nullptr };
+  size_t index{ 0 };
+  int cpu{ -1 };  // Pinned to, if pinning
+  int node{ 0 };  // NUMA node of "cpu", 0 if unknown
+  uint64_t rng{ 0 }; // Victim selection
+  std::thread thread{};
+};
+
+inline _impl_worker*& _impl_current_worker() {
+  static thread_local _impl_worker* worker{ nullptr };
+  return worker;
+}
+
+// State shared by all the pieces of one parallel_for() call. Lives on the caller's stack.
+struct _impl_for_state {
+  void (*body)(void* ctx, size_t begin, size_t end){ nullptr };
+  void* ctx{ nullptr };
+  size_t grain{ 1 };
+  std::atomic<size_t> remaining{ 0 }; // Indices not yet processed
+  std::atomic<bool> failed{ false };
+  std::exception_ptr error{};         // Written once, by whoever set "failed"
+
+  std::mutex mutex{};
+  std::condition_variable cv{};
+  bool done{ false };
+
+  void finish(const size_t n) {
+    if (remaining.fetch_sub(n, std::memory_order_acq_rel) != n) return;
+    const std::lock_guard<std::mutex> lock{ mutex };
+    done = true;
+    cv.notify_all();
+  }
+};
+
+struct _impl_range_task : _impl_task {
+  _impl_range_task(void (*fn)(_impl_task*), _impl_for_state* const s, const size_t b, const size_t e) :
+    _impl_task{ fn }, state{ s }, begin{ b }, end{ e } {}
+
+  _impl_for_state* state;
+  size_t begin;
+  size_t end;
+};
+
+template<typename F>
+struct _impl_fn_task : _impl_task {
+  _impl_fn_task(void (*fn_run)(_impl_task*), F&& f) : _impl_task{ fn_run }, fn{ std::move(f) } {}
+  F fn;
+};
+
+#ifdef __linux__
+// "0-3,8-11" -> sets the node of each listed CPU. false if the file doesn't exist.
+inline bool _impl_parse_cpulist(const char* const path, const int node, std::vector<int>& node_of) {
+  std::FILE* const file{ std::fopen(path, "r") };
+  if (!file) return false;
+  int lo{ 0 }, hi{ 0 };
+  char sep{ 0 };
+  while (std::fscanf(file, "%d", &lo) == 1) {
+    hi = lo;
+    if (std::fscanf(file, "%c", &sep) == 1 && sep == '-') {
+      if (std::fscanf(file, "%d", &hi) != 1) break;
+      if (std::fscanf(file, "%c", &sep) != 1) sep = 0;
+    }
+    for (int cpu{ lo }; cpu <= hi; ++cpu)
+      if (cpu >= 0 && static_cast<size_t>(cpu) < node_of.size()) node_of[static_cast<size_t>(cpu)] = node;
+    if (sep != ',') break;
+  }
+  std::fclose(file);
+  return true;
+}
+#endif // __linux__
+
+// CPUs the process may run on, ordered by NUMA node, as (cpu, node) pairs
+inline std::vector<std::pair<int, int>> _impl_cpu_topology() {
+  std::vector<std::pair<int, int>> cpus{};
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (::sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+    std::vector<int> node_of(CPU_SETSIZE, 0);
+    char path[96];
+    for (int node{ 0 }; node < 1024; ++node) {
+      std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+      if (!_impl_parse_cpulist(path, node, node_of)) break; // Nodes are numbered densely in practice
+    }
+    for (int cpu{ 0 }; cpu < CPU_SETSIZE; ++cpu)
+      if (CPU_ISSET(cpu, &allowed)) cpus.emplace_back(cpu, node_of[static_cast<size_t>(cpu)]);
+    std::stable_sort(cpus.begin(), cpus.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+  }
+#endif // __linux__
+  if (cpus.empty()) {
+    const unsigned n{ std::max(std::thread::hardware_concurrency(), 1u) };
+    for (unsigned i{ 0 }; i < n; ++i) cpus.emplace_back(-1, 0);
+  }
+  return cpus;
+}
+} // namespace detail
+
+class thread_pool {
+public:
+  explicit thread_pool(const thread_pool_options& opts = {}) {
+    const std::vector<std::pair<int, int>> cpus{ detail::_impl_cpu_topology() };
+    _size = opts.threads ? opts.threads : cpus.size();
+    _workers = std::make_unique<detail::_impl_worker[]>(_size);
+
+    for (size_t i{ 0 }; i < _size; ++i) {
+      detail::_impl_worker& w{ _workers[i] };
+      w.pool = this;
+      w.index = i;
+      w.node = cpus[i % cpus.size()].second;
+      w.cpu = opts.pin ? cpus[i % cpus.size()].first : -1;
+      w.rng = 0x9e3779b97f4a7c15ull * (i + 1);
+    }
+    for (size_t i{ 0 }; i < _size; ++i) _workers[i].thread = std::thread{ [this, i] { _impl_worker_loop(_workers[i]); } };
+  }
+
+  // Waits for everything submit()ted, then stops the workers
+  ~thread_pool() {
+    wait_idle();
+    _stop.store(true, std::memory_order_seq_cst);
+    _impl_wake(true);
+    for (size_t i{ 0 }; i < _size; ++i) _workers[i].thread.join();
+  }
+
+  // Workers keep a pointer to their pool
+  NO_COPY_MOVE(thread_pool)
+
+  [[nodiscard]] size_t size() const noexcept { return _size; }
+
+  /*
+   * Runs "fn()" on some worker, some time later. Fire and forget - see wait_idle().
+   * @param fn Callable with no arguments. Must not throw.
+   */
+  template<typename F>
+  void submit(F&& fn) {
+    using task_type = detail::_impl_fn_task<std::decay_t<F>>;
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    _impl_schedule(new task_type{ &_impl_run_submitted<task_type>, std::decay_t<F>{ std::forward<F>(fn) } });
+  }
+
+  // Blocks until every submit()ted task has run. Don't call it from a task.
+  void wait_idle() {
+    std::unique_lock<std::mutex> lock{ _idle_mutex };
+    _idle_cv.wait(lock, [this] { return !_pending.load(std::memory_order_acquire); });
+  }
+
+  /*
+   * Calls "body" for every index in [first, last), spread over the workers, and waits for all of them.
+   * Usage: "pool.parallel_for(0, n, [&](size_t i) { ... });"
+   * or, to amortize the call per index: "pool.parallel_for(0, n, [&](size_t begin, size_t end) { ... });"
+   * Can be nested: a worker calling it helps running the pieces instead of blocking.
+   * @param first First index
+   * @param last One past the last index
+   * @param body Callable with (size_t) or (size_t, size_t)
+   * @param grain Smallest piece handed to "body" at once. 0 picks one from the range and pool sizes.
+   * If "body" throws, the remaining pieces are skipped and the first exception is rethrown here.
+   */
+  template<typename F>
+  void parallel_for(const size_t first, const size_t last, F&& body, size_t grain = 0) {
+    if (first >= last) return;
+    using body_type = std::remove_reference_t<F>;
+    constexpr bool ranged{ std::is_invocable_v<body_type&, size_t, size_t> };
+    const auto call = [](void* const ctx, const size_t b, const size_t e) {
+      body_type& f{ *static_cast<body_type*>(ctx) };
+      if constexpr (ranged) f(b, e);
+      else for (size_t i{ b }; i < e; ++i) f(i);
+    };
+
+    const size_t n{ last - first };
+    if (!grain) grain = std::max<size_t>(n / (_size * 64), 1);
+    if (n <= grain) {
+      call(&body, first, last);
+      return;
+    }
+
+    detail::_impl_for_state state{};
+    state.body = call;
+    state.ctx = const_cast<void*>(static_cast<const void*>(&body));
+    state.grain = grain;
+    state.remaining.store(n, std::memory_order_relaxed);
+
+    _impl_schedule(object_pool<detail::_impl_range_task>::acquire(&_impl_run_range, &state, first, last));
+
+    detail::_impl_worker* const self{ detail::_impl_current_worker() };
+    if (self && self->pool == this) {
+      // Blocking a worker could deadlock the pool, so help out instead
+      while (state.remaining.load(std::memory_order_acquire)) {
+        if (detail::_impl_task* const task{ _impl_find_task(*self) }) task->run(task);
+        else std::this_thread::yield();
+      }
+      // remaining hits 0 before the last finish() takes the lock: wait for "done", or "state" could
+      // go out of scope under it
+      std::unique_lock<std::mutex> lock{ state.mutex };
+      state.cv.wait(lock, [&state] { return state.done; });
+    } else {
+      std::unique_lock<std::mutex> lock{ state.mutex };
+      state.cv.wait(lock, [&state] { return state.done; });
+    }
+
+    if (state.error) std::rethrow_exception(state.error);
+  }
+
+private:
+  // noexcept: a throwing task terminates, same as in a std::thread
+  template<typename Task>
+  static void _impl_run_submitted(detail::_impl_task* const task) noexcept {
+    thread_pool& pool{ *detail::_impl_current_worker()->pool };
+    {
+      const std::unique_ptr<Task> self{ static_cast<Task*>(task) };
+      self->fn();
+    }
+    if (pool._pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      const std::lock_guard<std::mutex> lock{ pool._idle_mutex };
+      pool._idle_cv.notify_all();
+    }
+  }
+
+  static void _impl_run_range(detail::_impl_task* const task) {
+    detail::_impl_range_task* const range{ static_cast<detail::_impl_range_task*>(task) };
+    detail::_impl_for_state& state{ *range->state };
+    size_t begin{ range->begin }, end{ range->end };
+    object_pool<detail::_impl_range_task>::release(range);
+
+    detail::_impl_worker* const self{ detail::_impl_current_worker() };
+    while (begin < end) {
+      // Lazy binary splitting: only give away half of the range once the last half was taken
+      if (end - begin > state.grain && self->deque.empty()) {
+        const size_t mid{ begin + (end - begin) / 2 };
+        detail::_impl_range_task* const half{
+          object_pool<detail::_impl_range_task>::acquire(&_impl_run_range, &state, mid, end) };
+        if (self->deque.push(half)) {
+          end = mid;
+          self->pool->_impl_wake(false);
+          continue;
+        }
+        object_pool<detail::_impl_range_task>::release(half);
+      }
+
+      const size_t stop{ std::min(end, begin + state.grain) };
+      if (LIKELY(!state.failed.load(std::memory_order_relaxed))) {
+        try {
+          state.body(state.ctx, begin, stop);
+        } catch (...) {
+          if (!state.failed.exchange(true, std::memory_order_acq_rel)) state.error = std::current_exception();
+        }
+      }
+      state.finish(stop - begin);
+      begin = stop;
+    }
+  }
+
+  void _impl_schedule(detail::_impl_task* const task) {
+    detail::_impl_worker* const self{ detail::_impl_current_worker() };
+    if (!self || self->pool != this || !self->deque.push(task)) {
+      const std::lock_guard<std::mutex> lock{ _inject_mutex };
+      _injected.push_back(task);
+      _injected_count.fetch_add(1, std::memory_order_release);
+    }
+    _impl_wake(false);
+  }
+
+  detail::_impl_task* _impl_take_injected() {
+    if (!_injected_count.load(std::memory_order_acquire)) return nullptr;
+    const std::lock_guard<std::mutex> lock{ _inject_mutex };
+    if (_injected.empty()) return nullptr;
+    detail::_impl_task* const task{ _injected.front() };
+    _injected.pop_front();
+    _injected_count.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+
+  // Same node first, then everybody else. Starts at a random victim so thieves spread out.
+  detail::_impl_task* _impl_steal(detail::_impl_worker& self) {
+    self.rng ^= self.rng << 13;
+    self.rng ^= self.rng >> 7;
+    self.rng ^= self.rng << 17;
+    const size_t start{ static_cast<size_t>(self.rng % _size) };
+    for (int pass{ 0 }; pass < 2; ++pass) {
+      for (size_t k{ 0 }; k < _size; ++k) {
+        detail::_impl_worker& victim{ _workers[(start + k) % _size] };
+        if (&victim == &self || (victim.node == self.node) != (pass == 0)) continue;
+        if (detail::_impl_task* const task{ victim.deque.steal() }) return task;
+      }
+    }
+    return nullptr;
+  }
+
+  detail::_impl_task* _impl_find_task(detail::_impl_worker& self) {
+    if (detail::_impl_task* const task{ self.deque.pop() }) return task;
+    if (detail::_impl_task* const task{ _impl_take_injected() }) return task;
+    return _impl_steal(self);
+  }
+
+  [[nodiscard]] bool _impl_has_work() const {
+    if (_injected_count.load(std::memory_order_acquire)) return true;
+    for (size_t i{ 0 }; i < _size; ++i)
+      if (!_workers[i].deque.empty()) return true;
+    return false;
+  }
+
+  // Called after publishing work. Pairs with the check in _impl_worker_loop(), see there.
+  void _impl_wake(const bool all) {
+    _epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (!all && !_sleeping.load(std::memory_order_seq_cst)) return;
+    { const std::lock_guard<std::mutex> lock{ _sleep_mutex }; }
+    if (all) _sleep_cv.notify_all();
+    else _sleep_cv.notify_one();
+  }
+
+  void _impl_worker_loop(detail::_impl_worker& self) {
+    detail::_impl_current_worker() = &self;
+#ifdef __linux__
+    if (self.cpu >= 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(self.cpu, &set);
+      ::sched_setaffinity(0, sizeof(set), &set); // Best effort
+    }
+#endif // __linux__
+
+    constexpr int spin_rounds{ 64 };
+    int idle{ 0 };
+    while (!_stop.load(std::memory_order_acquire)) {
+      if (detail::_impl_task* const task{ _impl_find_task(self) }) {
+        task->run(task);
+        idle = 0;
+        continue;
+      }
+      if (++idle < spin_rounds) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // Either a producer bumps the epoch before we read it (and we see its work in the scan
+      // below), or we're counted as sleeping before it checks (and it notifies us).
+      _sleeping.fetch_add(1, std::memory_order_seq_cst);
+      const uint64_t epoch{ _epoch.load(std::memory_order_seq_cst) };
+      if (!_impl_has_work()) {
+        std::unique_lock<std::mutex> lock{ _sleep_mutex };
+        _sleep_cv.wait(lock, [&] {
+          return _stop.load(std::memory_order_acquire) || _epoch.load(std::memory_order_seq_cst) != epoch;
+        });
+      }
+      _sleeping.fetch_sub(1, std::memory_order_relaxed);
+      idle = 0;
+    }
+    detail::_impl_current_worker() = nullptr;
+  }
+
+  size_t _size{ 0 };
+  std::unique_ptr<detail::_impl_worker[]> _workers{};
+
+  std::mutex _inject_mutex{};
+  std::deque<detail::_impl_task*> _injected{};
+  CACHELINE_ALIGNED std::atomic<size_t> _injected_count{ 0 };
+
+  CACHELINE_ALIGNED std::atomic<uint64_t> _epoch{ 0 };
+  std::atomic<size_t> _sleeping{ 0 };
+  std::atomic<bool> _stop{ false };
+  std::mutex _sleep_mutex{};
+  std::condition_variable _sleep_cv{};
+
+  std::atomic<size_t> _pending{ 0 }; // submit()ted tasks not done yet
+  std::mutex _idle_mutex{};
+  std::condition_variable _idle_cv{};
+}; // class thread_pool
+} // namespace selena
+
+#endif // SELENA_THREAD_POOL_HPP
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_TRACE_HPP
+#define SELENA_TRACE_HPP
+
+// Backing for SELENA_TRACE_SCOPE("name") from base.hpp.
+// Every thread owns a fixed-size ring of events. A scope writes one "complete" event (name, start,
+// end) into its thread's ring when it closes - a couple of TSC reads and stores, no allocation,
+// no locks. If the ring is full the event is dropped (and counted) rather than blocking.
+// write_chrome_trace() drains every ring into a Chrome Trace Event JSON file, which both
+// chrome://tracing and https://ui.perfetto.dev open.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+  #include <process.h>
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #include <unistd.h>
+#else
+  #include <unistd.h>
+#endif
+
+#include "base.hpp"
+
+namespace selena::trace {
+struct event {
+  const char* name{ nullptr }; // Must outlive the trace - string literals, in practice
+  uint64_t start{ 0 };         // Raw timestamps, see now()
+  uint64_t end{ 0 };
+  uint32_t tid{ 0 };
+};
+
+// Events each thread can hold between two flushes (32 bytes each). Must be a power of two.
+inline constexpr size_t ring_capacity{ size_t{ 1 } << 14 };
+
+// TSC where available, steady_clock nanoseconds elsewhere. Converted to wall units when flushing.
+inline uint64_t now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+namespace detail {
+// Single producer (the owning thread), single consumer (whoever holds the registry lock).
+struct _impl_ring {
+  event events[ring_capacity]{};
+  std::atomic<uint64_t> head{ 0 }; // Written by the producer
+  std::atomic<uint64_t> tail{ 0 }; // Written by the consumer
+  std::atomic<uint64_t> dropped{ 0 };
+  std::atomic<bool> alive{ true };
+  uint32_t tid{ 0 };
+};
+
+// Pairs of (raw timestamp, steady_clock) to turn raw timestamps into microseconds
+struct _impl_clock_anchor {
+  uint64_t raw{ 0 };
+  std::chrono::steady_clock::time_point steady{};
+};
+
+inline _impl_clock_anchor _impl_anchor_now() {
+  return { now(), std::chrono::steady_clock::now() };
+}
+
+struct _impl_registry {
+  std::mutex mutex{};
+  std::vector<std::unique_ptr<_impl_ring>> rings{};
+  uint32_t next_tid{ 1 };
+  const _impl_clock_anchor origin{ _impl_anchor_now() };
+};
+
+// Never destroyed, so threads exiting during static destruction can still let go of their ring.
+inline _impl_registry& _impl_get_registry() {
+  static _impl_registry* const registry{ new _impl_registry{} };
+  return *registry;
+}
+
+class _impl_thread_ring {
+public:
+  _impl_thread_ring() {
+    _impl_registry& registry{ _impl_get_registry() };
+    std::unique_ptr<_impl_ring> ring{ std::make_unique<_impl_ring>() };
+    _ring = ring.get();
+    const std::lock_guard<std::mutex> lock{ registry.mutex };
+    _ring->tid = registry.next_tid++;
+    registry.rings.push_back(std::move(ring));
+  }
+
+  // The ring stays registered until its last events are flushed
+  ~_impl_thread_ring() { _ring->alive.store(false, std::memory_order_release); }
+
+  NO_COPY_MOVE(_impl_thread_ring)
+
+  _impl_ring& ring() { return *_ring; }
+
+private:
+  _impl_ring* _ring{ nullptr };
+};
+
+inline _impl_ring& _impl_local_ring() {
+  static thread_local _impl_thread_ring ring{};
+  return ring.ring();
+}
+
+inline void _impl_push(_impl_ring& ring, const char* const name, const uint64_t start, const uint64_t end) {
+  const uint64_t head{ ring.head.load(std::memory_order_relaxed) };
+  if (head - ring.tail.load(std::memory_order_acquire) >= ring_capacity) {
+    ring.dropped.fetch_add(1, std::memory_order_relaxed); // Cold path, and drain() resets it
+    return;
+  }
+  ring.events[head & (ring_capacity - 1)] = { name, start, end, ring.tid };
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+inline void _impl_write_json_string(std::FILE* const out, const char* s) {
+  std::fputc('"', out);
+  for (; s && *s; ++s) {
+    const unsigned char c{ static_cast<unsigned char>(*s) };
+    if (c == '"' || c == '\\') std::fprintf(out, "\\%c", c);
+    else if (c < 0x20) std::fprintf(out, "\\u%04x", c);
+    else std::fputc(c, out);
+  }
+  std::fputc('"', out);
+}
+} // namespace detail
+
+// What SELENA_TRACE_SCOPE expands to. Records one event covering its own lifetime.
+class scope {
+public:
+  // The ring is looked up first, so the very first scope doesn't predate the clock anchor
+  explicit scope(const char* const name) : _ring{ detail::_impl_local_ring() }, _name{ name }, _start{ now() } {}
+  ~scope() { detail::_impl_push(_ring, _name, _start, now()); }
+
+  NO_COPY_MOVE(scope)
+
+private:
+  detail::_impl_ring& _ring;
+  const char* _name;
+  uint64_t _start;
+};
+
+/*
+ * Moves every buffered event, from every thread, into "out".
+ * @param out Receives the events, appended
+ * @returns size_t Number of events dropped because a ring was full, since the last drain()
+ */
+inline size_t drain(std::vector<event>& out) {
+  detail::_impl_registry& registry{ detail::_impl_get_registry() };
+  const std::lock_guard<std::mutex> lock{ registry.mutex };
+
+  size_t dropped{ 0 };
+  for (std::unique_ptr<detail::_impl_ring>& ring : registry.rings) {
+    const bool alive{ ring->alive.load(std::memory_order_acquire) };
+    const uint64_t head{ ring->head.load(std::memory_order_acquire) };
+    for (uint64_t i{ ring->tail.load(std::memory_order_relaxed) }; i < head; ++i)
+      out.push_back(ring->events[i & (ring_capacity - 1)]);
+    ring->tail.store(head, std::memory_order_release);
+    dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+    if (!alive) ring.reset(); // Its thread is gone and nothing is left in it
+  }
+  registry.rings.erase(std::remove(registry.rings.begin(), registry.rings.end(), nullptr), registry.rings.end());
+  return dropped;
+}
+
+/*
+ * Drains all buffered events into a Chrome Trace Event / Perfetto compatible JSON file.
+ * Can be called periodically; each call writes a complete file with the events since the last one.
+ * @param path Where to write the JSON
+ * @returns bool false if the file couldn't be written
+ */
+inline bool write_chrome_trace(const char* const path) {
+  std::vector<event> events{};
+  const size_t dropped{ drain(events) };
+  std::sort(events.begin(), events.end(), [](const event& a, const event& b) { return a.start < b.start; });
+
+  std::FILE* const out{ std::fopen(path, "w") };
+  if (!out) return false;
+
+  // Raw timestamps -> microseconds since the first trace call, from two anchor points
+  const detail::_impl_clock_anchor& origin{ detail::_impl_get_registry().origin };
+  const detail::_impl_clock_anchor end{ detail::_impl_anchor_now() };
+  const double elapsed_us{ std::chrono::duration<double, std::micro>(end.steady - origin.steady).count() };
+  const double raw_span{ static_cast<double>(end.raw - origin.raw) };
+  const double us_per_raw{ raw_span > 0 ? elapsed_us / raw_span : 0 };
+  const auto to_us = [&](const uint64_t raw) {
+    return (static_cast<double>(raw) - static_cast<double>(origin.raw)) * us_per_raw;
+  };
+
+#ifdef _WIN32
+  const int pid{ _getpid() };
+#else
+  const int pid{ static_cast<int>(::getpid()) };
+#endif
+
+  std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":%zu},\"traceEvents\":[\n", dropped);
+  for (size_t i{ 0 }; i < events.size(); ++i) {
+    const event& e{ events[i] };
+    std::fprintf(out, "{\"name\":");
+    detail::_impl_write_json_string(out, e.name);
+    std::fprintf(out, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u}%s\n", to_us(e.start),
+      to_us(e.end) - to_us(e.start), pid, e.tid, i + 1 < events.size() ? "," : "");
+  }
+  std::fprintf(out, "]}\n");
+  return std::fclose(out) == 0;
+}
+} // namespace selena::trace
+
+#endif // SELENA_TRACE_HPP
@@ -21,12 +21,21 @@
 #include <string>
 #include <string_view>
 #include <regex>
+#include <vector>
 #include <algorithm>
+#include <memory_resource>
 
 #include <cctype>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 
+#include "base.hpp"
+#include "instrument.hpp"
+#include "kernels.hpp"
+#include "process.hpp"
+#include "thread_pool.hpp"
+
 namespace selena {
 /*
  * Uses <regex> to match a given input string to a given pattern.
@@ -36,17 +45,20 @@ namespace selena {
  * @return true/false
  */
 [[nodiscard]] inline bool is_valid_format(const std::string& input, const std::string& re_pattern) {
+  SELENA_TIME(is_valid_format);
+  SELENA_COUNT(regex_compiles, 1);
   return std::regex_match(input, std::regex{ re_pattern });
 }
 
 /*
  * Uses <regex> to match a given input string to a given pattern.
- * @param input A string object
+ * @param input A string view, ex. a line of a file_reader block - no copy is made
  * @param re_pattern A regex object
  * @return true/false
  */
-[[nodiscard]] inline bool is_valid_format(const std::string& input, const std::regex& re_pattern) {
-  return std::regex_match(input, re_pattern);
+[[nodiscard]] inline bool is_valid_format(const std::string_view input, const std::regex& re_pattern) {
+  SELENA_TIME(is_valid_format);
+  return std::regex_match(input.begin(), input.end(), re_pattern);
 }
 
 /*
@@ -55,18 +67,19 @@ namespace selena {
  * Also blocks characters which don't have a visible representation, this includes spaces.
  * As for the meaning of "validity", it only checks if the string "looks" like an URL.
  * It doesn't not verify the actual existence of the URL.
- * @param url A string object
+ * @param url A string view, ex. a line of a file_reader block - no copy is made
  * @return true/false
  */
-[[nodiscard]] inline bool is_valid_url(const std::string& url) {
-  if (url.empty()) return false;
+[[nodiscard]] HOT inline bool is_valid_url(const std::string_view url) {
+  SELENA_TIME(is_valid_url);
+  if (UNLIKELY(url.empty())) return false;
 
   // URL must be a http or https. Block anything that doesn't belong with 'h'.
   if (const char c{ static_cast<char>(std::tolower(static_cast<unsigned char>(url[0]))) }; c != 'h')
     return false;
 
   const size_t sep_pos{ url.find("://") };
-  if (sep_pos == std::string::npos) return false;
+  if (sep_pos == std::string_view::npos) return false;
   if (sep_pos != 4 && sep_pos != 5) return false; // http/https restriction
 
   const char* const base_scheme{ "http" };
@@ -80,13 +93,35 @@ namespace selena {
 
   if ((sep_pos + 3) >= url.length()) return false; // + 3 because "://"
 
-  for (size_t i{ sep_pos + 3 }; i < url.length(); ++i) { // + 3 because "://"
-    const unsigned char c{ static_cast<unsigned char>(url[i]) };
-    if (c == ';' || c == '|' || c == '`' || c == '$') return false;
-    if (!std::isgraph(c)) return false; // Blocks anything that doesn't have a graphical representation
-  }
+  // Blocks ';', '|', '`', '$' and anything that doesn't have a graphical representation
+  const size_t rest{ sep_pos + 3 }; // + 3 because "://"
+  return kernels::find_url_reject(url.data() + rest, url.length() - rest) == kernels::npos;
+}
 
-  return true;
+/*
+ * Matches every input against the same pattern, spread over the workers of "pool".
+ * @param inputs The strings to check
+ * @param re_pattern A regex object. Only ever used through const, so sharing it is fine.
+ * @param pool The selena::thread_pool to run on
+ * @return std::vector<uint8_t> 1 / 0 per input, in the same order
+ */
+[[nodiscard]] inline std::vector<uint8_t> is_valid_format(const std::vector<std::string>& inputs,
+  const std::regex& re_pattern, thread_pool& pool) {
+  std::vector<uint8_t> ret(inputs.size());
+  pool.parallel_for(0, inputs.size(), [&](const size_t i) { ret[i] = is_valid_format(inputs[i], re_pattern); }, 16);
+  return ret;
+}
+
+/*
+ * selena::is_valid_url() on every URL, spread over the workers of "pool".
+ * @param urls The strings to check
+ * @param pool The selena::thread_pool to run on
+ * @return std::vector<uint8_t> 1 / 0 per URL, in the same order
+ */
+[[nodiscard]] inline std::vector<uint8_t> is_valid_url(const std::vector<std::string>& urls, thread_pool& pool) {
+  std::vector<uint8_t> ret(urls.size());
+  pool.parallel_for(0, urls.size(), [&](const size_t i) { ret[i] = is_valid_url(urls[i]); }, 1024);
+  return ret;
 }
 
 /*
@@ -95,11 +130,25 @@ namespace selena {
  * @return std::string A string object containing the returned value
  */
 inline std::string getenv(const char* const var_name) {
+  SELENA_TIME(getenv);
   if (!var_name) return "";
   const char* const var{ std::getenv(var_name) };
   return var ? var : "";
 }
 
+/*
+ * Same as above, but the returned string allocates from "resource", ex. a selena::arena.
+ * @param var_name A const char* to a C-style string
+ * @param resource Where the string's buffer comes from
+ * @return std::pmr::string A string object containing the returned value
+ */
+inline std::pmr::string getenv(const char* const var_name, std::pmr::memory_resource* const resource) {
+  SELENA_TIME(getenv);
+  if (!var_name) return std::pmr::string{ resource };
+  const char* const var{ std::getenv(var_name) };
+  return std::pmr::string{ var ? var : "", resource };
+}
+
 /*
  * Does a case-insensitive comparison of two characters.
  * Especially useful in algorithms like std::search.
@@ -107,7 +156,7 @@ inline std::string getenv(const char* const var_name) {
  * @param c2 Another unsigned char
  * @returns true/false
  */
-[[nodiscard]] inline bool iequal(const unsigned char c1, const unsigned char c2) {
+[[nodiscard]] FORCE_INLINE bool iequal(const unsigned char c1, const unsigned char c2) {
   return std::tolower(c1) == std::tolower(c2);
 }
 
@@ -118,25 +167,23 @@ inline std::string getenv(const char* const var_name) {
  * @returns true/false
  */
 [[nodiscard]] inline bool iequal_str(const std::string_view str1, const std::string_view str2) {
+  SELENA_TIME(iequal_str);
   if (str1.size() != str2.size()) return false;
   return std::equal(str1.begin(), str1.end(), str2.begin(), selena::iequal);
 }
 
 /*
  * Checks if a target string is a part of a given text.
- * Makes use of selena::iequal.
+ * Case folding is ASCII-only (same as selena::iequal in the "C" locale).
+ * Makes use of selena::kernels::ifind.
  * @param text The base text
  * @param target The text to search for
  * @returns true/false
  */
-[[nodiscard]] inline bool icontains(const std::string_view text, const std::string_view target) {
-  const std::string_view::const_iterator it{ std::search(
-      text.begin(), text.end(),
-      target.begin(), target.end(),
-      selena::iequal
-  ) };
-
-  return it != text.end();
+[[nodiscard]] HOT inline bool icontains(const std::string_view text, const std::string_view target) {
+  SELENA_TIME(icontains);
+  if (target.empty()) return !text.empty(); // Same as std::search - an empty target matches at begin()
+  return kernels::ifind(text.data(), text.size(), target.data(), target.size()) != kernels::npos;
 }
 
 /*
@@ -150,7 +197,8 @@ inline std::string getenv(const char* const var_name) {
  * @param cmd A C-style string which specifies the command
  * @returns int The value returned from the system call
  */
-[[nodiscard]] inline int system(const char* const cmd) {
+[[nodiscard]] COLD inline int system(const char* const cmd) {
+  SELENA_TIME(system);
   if (!cmd) return 1;
 #ifdef _WIN32
   if (!std::strcmp(cmd, "clear")) return std::system("cls");
@@ -166,10 +214,13 @@ inline std::string getenv(const char* const var_name) {
  * type is declared [[nodiscard]]. If you feel like discarding, cast it to void, or something else.
  * It is however a good practice to always check the return code of commands.
  * Note-3: It is blind - it does NOT check for "dangerous" commands.
+ * Note-4: On POSIX, this doesn't append a redirection and go through std::system(). The output is
+ * wired to /dev/null by selena::run_shell(), and plain commands skip /bin/sh altogether.
  * @param cmd A C-style string which specifies the command
  * @returns int The value returned from the system call
  */
-[[nodiscard]] inline int system_suppressed(const char* const cmd) {
+[[nodiscard]] COLD inline int system_suppressed(const char* const cmd) {
+  SELENA_TIME(system_suppressed);
   if (!cmd) return 1;
 #ifdef _WIN32
     if (!std::strcmp(cmd, "clear")) return std::system("cls");
@@ -179,10 +230,31 @@ inline std::string getenv(const char* const var_name) {
 
 #ifdef _WIN32
   const std::string suppressed_cmd{ cmd + std::string{" > NUL 2>&1"} };
+  return std::system(suppressed_cmd.c_str());
 #else // ^^^ _WIN32 || !_WIN32 vvv
-  const std::string suppressed_cmd{ cmd + std::string{" > /dev/null 2>&1"} };
+  spawn_options opts{};
+  opts.suppressed = true;
+  return selena::run_shell(cmd, opts);
 #endif // _WIN32
+}
+
+/*
+ * Same as above, but whatever needs allocating comes from "resource", ex. a selena::arena.
+ * On POSIX nothing does, and this is just system_suppressed(cmd).
+ * @param cmd A C-style string which specifies the command
+ * @param resource Where the command line is built (Windows)
+ * @returns int The value returned from the system call
+ */
+[[nodiscard]] COLD inline int system_suppressed(const char* const cmd, [[maybe_unused]] std::pmr::memory_resource* const resource) {
+#ifdef _WIN32
+  if (!cmd || !std::strcmp(cmd, "clear")) return selena::system_suppressed(cmd);
+  SELENA_TIME(system_suppressed);
+  std::pmr::string suppressed_cmd{ cmd, resource };
+  suppressed_cmd += " > NUL 2>&1";
   return std::system(suppressed_cmd.c_str());
+#else // ^^^ _WIN32 || !_WIN32 vvv
+  return selena::system_suppressed(cmd);
+#endif // _WIN32
 }
 } // namespace selena
 
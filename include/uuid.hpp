@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_UUID_HPP
+#define SELENA_UUID_HPP
+
+// RFC 9562 UUIDs, drawn from the thread-local engines of random_prng (default) or random_trng:
+//   const selena::uuid id{ selena::uuid_v7() };   // Time-ordered, ex. request IDs / database keys
+//   const std::string text{ id.to_string() };     // "018f3c1e-7b2a-7c4d-8e9f-0123456789ab"
+// Formatting and parsing work on fixed positions through lookup tables: no branches on the data,
+// and every position is independent, so the compiler is free to vectorize them.
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "base.hpp"
+#include "random.hpp"
+
+namespace selena {
+namespace detail {
+// Offset of every byte's two hex digits in the text form
+inline constexpr uint8_t _impl_uuid_pos[16]{ 0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34 };
+
+// Byte -> its two lowercase hex digits
+inline constexpr std::array<char, 512> _impl_hex_pairs{ [] {
+  constexpr char digits[]{ "0123456789abcdef" };
+  std::array<char, 512> ret{};
+  for (size_t b{ 0 }; b < 256; ++b) {
+    ret[b * 2] = digits[b >> 4];
+    ret[b * 2 + 1] = digits[b & 0xf];
+  }
+  return ret;
+}() };
+
+// Character -> its hex value, 0xff if it isn't a hex digit (either case)
+inline constexpr std::array<uint8_t, 256> _impl_hex_values{ [] {
+  std::array<uint8_t, 256> ret{};
+  for (size_t c{ 0 }; c < 256; ++c) ret[c] = 0xff;
+  for (uint8_t i{ 0 }; i < 10; ++i) ret['0' + i] = i;
+  for (uint8_t i{ 0 }; i < 6; ++i) ret['a' + i] = ret['A' + i] = static_cast<uint8_t>(10 + i);
+  return ret;
+}() };
+} // namespace detail
+
+// 16 bytes, in the RFC's (big endian) order, so comparing them orders v7 UUIDs by time
+struct uuid {
+  std::array<uint8_t, 16> bytes{};
+
+  // Length of the text form
+  static constexpr size_t string_size{ 36 };
+
+  [[nodiscard]] constexpr unsigned version() const noexcept { return bytes[6] >> 4; }
+
+  [[nodiscard]] bool is_nil() const noexcept { return *this == uuid{}; }
+
+  // Milliseconds since the Unix epoch, for v7 UUIDs
+  [[nodiscard]] uint64_t timestamp_ms() const noexcept {
+    uint64_t ms{ 0 };
+    for (size_t i{ 0 }; i < 6; ++i) ms = (ms << 8) | bytes[i];
+    return ms;
+  }
+
+  /*
+   * Writes the lowercase text form. Usage: "char text[36]; id.to_chars(text);"
+   * @param out At least 36 chars. Not null-terminated.
+   */
+  FORCE_INLINE void to_chars(char* const out) const noexcept {
+    for (size_t i{ 0 }; i < 16; ++i) std::memcpy(out + detail::_impl_uuid_pos[i], &detail::_impl_hex_pairs[bytes[i] * 2], 2);
+    out[8] = out[13] = out[18] = out[23] = '-';
+  }
+
+  [[nodiscard]] std::string to_string() const {
+    std::string ret(string_size, '\0');
+    to_chars(ret.data());
+    return ret;
+  }
+
+  /*
+   * Parses the 36 character text form, either case. No braces, no "urn:uuid:" prefix.
+   * @param text The text
+   * @returns std::optional<uuid> Empty if "text" isn't a UUID
+   */
+  [[nodiscard]] static std::optional<uuid> parse(const std::string_view text) noexcept {
+    if (text.size() != string_size) return std::nullopt;
+    const unsigned char* const in{ reinterpret_cast<const unsigned char*>(text.data()) };
+    uuid ret{};
+    uint8_t bad{ 0 };
+    for (size_t i{ 0 }; i < 16; ++i) {
+      const uint8_t hi{ detail::_impl_hex_values[in[detail::_impl_uuid_pos[i]]] };
+      const uint8_t lo{ detail::_impl_hex_values[in[detail::_impl_uuid_pos[i] + 1]] };
+      bad |= hi | lo;
+      ret.bytes[i] = static_cast<uint8_t>((hi << 4) | (lo & 0xf));
+    }
+    bad |= static_cast<uint8_t>((in[8] != '-') | (in[13] != '-') | (in[18] != '-') | (in[23] != '-')) << 7;
+    if (bad & 0x80) return std::nullopt; // Only invalid digits (0xff) and dashes set the top bit
+    return ret;
+  }
+
+  friend bool operator==(const uuid& a, const uuid& b) noexcept { return a.bytes == b.bytes; }
+  friend bool operator!=(const uuid& a, const uuid& b) noexcept { return a.bytes != b.bytes; }
+  friend bool operator<(const uuid& a, const uuid& b) noexcept { return a.bytes < b.bytes; }
+  friend bool operator>(const uuid& a, const uuid& b) noexcept { return b < a; }
+  friend bool operator<=(const uuid& a, const uuid& b) noexcept { return !(b < a); }
+  friend bool operator>=(const uuid& a, const uuid& b) noexcept { return !(a < b); }
+}; // struct uuid
+
+static_assert(sizeof(uuid) == 16);
+
+namespace detail {
+FORCE_INLINE void _impl_uuid_set_version(uuid& id, const uint8_t version) {
+  id.bytes[6] = static_cast<uint8_t>((id.bytes[6] & 0x0f) | (version << 4));
+  id.bytes[8] = static_cast<uint8_t>((id.bytes[8] & 0x3f) | 0x80); // RFC 9562 variant
+}
+
+// Per thread, per engine: the last timestamp handed out and the counter within it
+template<typename Rng>
+struct _impl_uuid_v7_clock {
+  uint64_t ms{ 0 };
+  uint64_t counter{ 0 };
+
+  static _impl_uuid_v7_clock& local() {
+    static thread_local _impl_uuid_v7_clock clock{};
+    return clock;
+  }
+};
+} // namespace detail
+
+/*
+ * A random (version 4) UUID. 122 random bits from one random_bytes() call.
+ * @tparam Rng random_prng (default) or random_trng, for IDs which must not be guessable
+ * @returns uuid
+ */
+template<typename Rng = random_prng>
+[[nodiscard]] uuid uuid_v4() {
+  uuid ret{};
+  Rng::random_bytes(ret.bytes.data(), ret.bytes.size());
+  detail::_impl_uuid_set_version(ret, 4);
+  return ret;
+}
+
+/*
+ * A time-ordered (version 7) UUID: a 48-bit Unix timestamp in ms, then a 42-bit counter (RFC 9562,
+ * "fixed bit-length dedicated counter") and 32 random bits.
+ * UUIDs from the same thread always increase, even within a millisecond or if the clock goes back:
+ * the counter restarts from a random value (top bit clear, leaving room to count) on every new
+ * millisecond, and borrows the next millisecond if it runs out.
+ * @tparam Rng random_prng (default) or random_trng
+ * @returns uuid
+ */
+template<typename Rng = random_prng>
+[[nodiscard]] uuid uuid_v7() {
+  constexpr uint64_t counter_bits{ 42 };
+  detail::_impl_uuid_v7_clock<Rng>& clock{ detail::_impl_uuid_v7_clock<Rng>::local() };
+
+  const uint64_t now{ static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count()) };
+  uint32_t tail{ 0 };
+  Rng::random_bytes(&tail, sizeof(tail));
+  if (now > clock.ms || ++clock.counter >> counter_bits) {
+    clock.ms = now > clock.ms ? now : clock.ms + 1;
+    uint64_t seed{ 0 };
+    Rng::random_bytes(&seed, sizeof(seed));
+    clock.counter = seed & ((uint64_t{ 1 } << (counter_bits - 1)) - 1);
+  }
+
+  uuid ret{};
+  for (size_t i{ 0 }; i < 6; ++i) ret.bytes[i] = static_cast<uint8_t>(clock.ms >> (40 - 8 * i));
+  const uint64_t c{ clock.counter };
+  ret.bytes[6] = static_cast<uint8_t>(c >> 38);
+  ret.bytes[7] = static_cast<uint8_t>(c >> 30);
+  ret.bytes[8] = static_cast<uint8_t>(c >> 24);
+  ret.bytes[9] = static_cast<uint8_t>(c >> 16);
+  ret.bytes[10] = static_cast<uint8_t>(c >> 8);
+  ret.bytes[11] = static_cast<uint8_t>(c);
+  std::memcpy(&ret.bytes[12], &tail, sizeof(tail));
+  detail::_impl_uuid_set_version(ret, 7);
+  return ret;
+}
+} // namespace selena
+
+// So that uuids can key std::unordered_map / std::unordered_set
+namespace std {
+template<>
+struct hash<selena::uuid> {
+  size_t operator()(const selena::uuid& id) const noexcept {
+    uint64_t hi{ 0 }, lo{ 0 };
+    std::memcpy(&hi, id.bytes.data(), 8);
+    std::memcpy(&lo, id.bytes.data() + 8, 8);
+    return static_cast<size_t>(hi ^ (lo * 0x9e3779b97f4a7c15ull));
+  }
+};
+} // namespace std
+
+#endif // SELENA_UUID_HPP
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELENA_ZYGOTE_HPP
+#define SELENA_ZYGOTE_HPP
+
+// POSIX only - a forked helper talking over a Unix socket.
+#ifndef _WIN32
+
+#include <mutex>
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+  #include <sys/prctl.h>
+#endif // __linux__
+
+#include "base.hpp"
+#include "process.hpp"
+
+namespace selena {
+namespace detail {
+#ifdef MSG_NOSIGNAL
+  inline constexpr int _impl_zygote_send_flags{ MSG_NOSIGNAL };
+#else // ^^^ MSG_NOSIGNAL || !MSG_NOSIGNAL vvv
+  inline constexpr int _impl_zygote_send_flags{ 0 };
+#endif // MSG_NOSIGNAL
+
+// Request header. Followed by "size" bytes of NUL-separated arguments (or the one shell command).
+// Up to two fds (stdout, then stderr) travel along with it as SCM_RIGHTS.
+struct _impl_zygote_request {
+  uint32_t size{ 0 };
+  uint8_t shell{ 0 };
+  uint8_t suppressed{ 0 };
+  uint8_t search_path{ 0 };
+  uint8_t fd_mask{ 0 }; // bit 0 - stdout_fd attached, bit 1 - stderr_fd attached
+};
+
+inline constexpr size_t _impl_zygote_max_payload{ 1 << 16 };
+inline constexpr size_t _impl_zygote_max_args{ 256 };
+
+inline bool _impl_zygote_read_all(const int fd, void* const data, size_t len) {
+  char* p{ static_cast<char*>(data) };
+  while (len) {
+    const ssize_t got{ ::read(fd, p, len) };
+    if (got > 0) {
+      p += got;
+      len -= static_cast<size_t>(got);
+    } else if (!got || errno != EINTR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline bool _impl_zygote_write_all(const int fd, const void* const data, size_t len) {
+  const char* p{ static_cast<const char*>(data) };
+  while (len) {
+    const ssize_t sent{ ::send(fd, p, len, _impl_zygote_send_flags) };
+    if (sent > 0) {
+      p += sent;
+      len -= static_cast<size_t>(sent);
+    } else if (sent == -1 && errno != EINTR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The helper's main loop. Runs in the forked child, never returns. It does allocate - run() /
+// run_shell() build posix_spawn file actions, and long shell commands go to the heap - so it's
+// only safe if no other thread existed at fork() time, see zygote.
+[[noreturn]] inline void _impl_zygote_main(const int sock) {
+  static char payload[_impl_zygote_max_payload + 1];
+  for (;;) {
+    _impl_zygote_request req{};
+    int fds[2]{ -1, -1 };
+
+    iovec iov{ &req, sizeof(req) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 2)];
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t got{ 0 };
+    do got = ::recvmsg(sock, &msg, 0); while (got == -1 && errno == EINTR);
+    if (got <= 0) ::_exit(0); // Parent went away
+
+    // Every fd which came along has to be closed, whatever it was meant for
+    int received[2]{ -1, -1 };
+    size_t received_count{ 0 };
+    for (cmsghdr* c{ CMSG_FIRSTHDR(&msg) }; c; c = CMSG_NXTHDR(&msg, c)) {
+      if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+      const size_t n{ (c->cmsg_len - CMSG_LEN(0)) / sizeof(int) };
+      for (size_t i{ 0 }; i < n && received_count < 2; ++i)
+        std::memcpy(&received[received_count++], CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+    }
+    size_t next{ 0 };
+    if (req.fd_mask & 1) fds[0] = received[next++];
+    if (req.fd_mask & 2) fds[1] = received[next++];
+
+    if (static_cast<size_t>(got) < sizeof(req) && !_impl_zygote_read_all(sock, reinterpret_cast<char*>(&req) + got, sizeof(req) - got))
+      ::_exit(0);
+    if (req.size > _impl_zygote_max_payload || !_impl_zygote_read_all(sock, payload, req.size)) ::_exit(0);
+    payload[req.size] = '\0';
+
+    spawn_options opts{};
+    opts.suppressed = req.suppressed;
+    opts.search_path = req.search_path;
+    opts.stdout_fd = fds[0];
+    opts.stderr_fd = fds[1];
+
+    int32_t status{ -1 };
+    if (req.shell) {
+      status = selena::run_shell(payload, opts);
+    } else {
+      const char* argv[_impl_zygote_max_args + 1]{};
+      size_t argc{ 0 };
+      for (size_t i{ 0 }; i < req.size && argc < _impl_zygote_max_args; i += std::strlen(payload + i) + 1)
+        argv[argc++] = payload + i;
+      status = selena::run(argv, opts);
+    }
+
+    for (size_t i{ 0 }; i < received_count; ++i) ::close(received[i]);
+    if (!_impl_zygote_write_all(sock, &status, sizeof(status))) ::_exit(0);
+  }
+}
+} // namespace detail
+
+/*
+ * A small pre-forked launcher process. Commands are sent to it over a Unix socket and
+ * it spawns them on our behalf, so the request path never forks this (possibly huge) process.
+ * Construct it first thing in main(), while the RSS is still small and before any other thread
+ * exists: the helper is a plain fork() of this process which goes on allocating, so a lock some
+ * other thread held at that point would stay locked in it forever. The helper keeps the
+ * environment and working directory this process had when the zygote was constructed.
+ * On Linux the helper is killed when the thread which constructed the zygote exits (not only
+ * the process - PR_SET_PDEATHSIG follows the forking thread), so construct it on the main thread.
+ * Thread-safe: concurrent run() calls are serialized. For parallelism, keep several zygotes.
+ */
+class zygote {
+public:
+  zygote() {
+    int socks[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, socks) == -1) return;
+
+    const pid_t parent{ ::getpid() };
+    const pid_t pid{ ::fork() };
+    if (pid == -1) {
+      ::close(socks[0]);
+      ::close(socks[1]);
+      return;
+    }
+
+    if (!pid) {
+      ::close(socks[0]);
+#ifdef __linux__
+      ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+      if (::getppid() != parent) ::_exit(0); // Parent died before prctl(): nobody would kill us
+#endif // __linux__
+      ::signal(SIGPIPE, SIG_IGN);
+      ::signal(SIGCHLD, SIG_DFL);
+      detail::_impl_zygote_main(socks[1]);
+    }
+
+    ::close(socks[1]);
+    _sock = socks[0];
+    _pid = pid;
+  }
+
+  ~zygote() {
+    if (_sock == -1) return;
+    ::close(_sock); // The helper sees EOF and exits
+    detail::_impl_waitpid(_pid);
+  }
+
+  NO_COPY_MOVE(zygote)
+
+  // false if the helper couldn't be started, or has died since
+  [[nodiscard]] bool ok() const { return _sock != -1; }
+
+  /*
+   * Same as selena::run(), only the spawning happens in the helper.
+   * @param argv A nullptr-terminated argument vector, argv[0] being the program
+   * @param opts See selena::spawn_options. stdout_fd / stderr_fd are passed to the helper.
+   * @returns int The wait status, or -1 if the helper couldn't be reached
+   */
+  [[nodiscard]] int run(const char* const* const argv, const spawn_options& opts = {}) {
+    if (!argv || !argv[0]) return -1;
+    size_t size{ 0 }, argc{ 0 };
+    for (; argv[argc]; ++argc) size += std::strlen(argv[argc]) + 1;
+    if (size > detail::_impl_zygote_max_payload || argc > detail::_impl_zygote_max_args) return -1;
+    return _request(false, argv, argc, size, opts);
+  }
+
+  /*
+   * Same as selena::run_shell(), only the spawning happens in the helper.
+   * @param cmd A C-style string which specifies the command
+   * @param opts See selena::spawn_options
+   * @returns int The wait status, or -1 if the helper couldn't be reached
+   */
+  [[nodiscard]] int run_shell(const char* const cmd, const spawn_options& opts = {}) {
+    if (!cmd) return 1;
+    const size_t size{ std::strlen(cmd) + 1 };
+    if (size > detail::_impl_zygote_max_payload) return -1;
+    const char* const argv[]{ cmd, nullptr };
+    return _request(true, argv, 1, size, opts);
+  }
+
+private:
+  int _request(const bool shell, const char* const* const argv, const size_t argc, const size_t size, const spawn_options& opts) {
+    const std::lock_guard<std::mutex> lock{ _mutex };
+    if (_sock == -1) return -1;
+
+    detail::_impl_zygote_request req{};
+    req.size = static_cast<uint32_t>(size);
+    req.shell = shell;
+    req.suppressed = opts.suppressed;
+    req.search_path = opts.search_path;
+
+    int fds[2];
+    size_t fd_count{ 0 };
+    if (opts.stdout_fd != -1) { req.fd_mask |= 1; fds[fd_count++] = opts.stdout_fd; }
+    if (opts.stderr_fd != -1) { req.fd_mask |= 2; fds[fd_count++] = opts.stderr_fd; }
+
+    iovec iov{ &req, sizeof(req) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 2)]{};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (fd_count) {
+      msg.msg_control = control;
+      msg.msg_controllen = CMSG_SPACE(sizeof(int) * fd_count);
+      cmsghdr* const c{ CMSG_FIRSTHDR(&msg) };
+      c->cmsg_level = SOL_SOCKET;
+      c->cmsg_type = SCM_RIGHTS;
+      c->cmsg_len = CMSG_LEN(sizeof(int) * fd_count);
+      std::memcpy(CMSG_DATA(c), fds, sizeof(int) * fd_count);
+    }
+
+    ssize_t sent{ 0 };
+    do sent = ::sendmsg(_sock, &msg, detail::_impl_zygote_send_flags); while (sent == -1 && errno == EINTR);
+    bool alive{ sent != -1 };
+    if (alive && static_cast<size_t>(sent) < sizeof(req))
+      alive = detail::_impl_zygote_write_all(_sock, reinterpret_cast<const char*>(&req) + sent, sizeof(req) - sent);
+    for (size_t i{ 0 }; alive && i < argc; ++i)
+      alive = detail::_impl_zygote_write_all(_sock, argv[i], std::strlen(argv[i]) + 1);
+
+    int32_t status{ -1 };
+    if (alive) alive = detail::_impl_zygote_read_all(_sock, &status, sizeof(status));
+    if (!alive) { // Helper is gone, don't keep talking to a dead socket
+      ::close(_sock);
+      _sock = -1;
+      detail::_impl_waitpid(_pid);
+      return -1;
+    }
+    return status;
+  }
+
+  int _sock{ -1 };
+  pid_t _pid{ -1 };
+  std::mutex _mutex{};
+}; // class zygote
+} // namespace selena
+
+#endif // _WIN32
+
+#endif // SELENA_ZYGOTE_HPP
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Out-of-line, multi-ISA builds of the kernels in kernels.hpp. Compiled as the "selena::kernels"
+// CMake target, which also defines SELENA_HAS_KERNELS for whoever links it.
+
+#include "kernels.hpp"
+
+// target_clones emits one copy per ISA level (x86-64-v4 ~ AVX-512BW, x86-64-v3 ~ AVX2) plus an ifunc
+// resolver which picks one from cpuid when the binary is loaded. Needs GCC 12+ (or a recent Clang)
+// on an ELF / glibc x86-64 target. Define SELENA_NO_TARGET_CLONES to build a single baseline copy.
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__)) && !defined(SELENA_NO_TARGET_CLONES)
+  #define SELENA_KERNEL __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#else
+  #define SELENA_KERNEL
+#endif
+
+namespace selena::kernels {
+SELENA_KERNEL size_t find_url_reject(const char* const data, const size_t len) noexcept {
+  return detail::_impl_find_url_reject(data, len);
+}
+
+SELENA_KERNEL size_t ifind(const char* const text, const size_t len, const char* const target, const size_t target_len) noexcept {
+  return detail::_impl_ifind(text, len, target, target_len);
+}
+} // namespace selena::kernels
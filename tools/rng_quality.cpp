@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2026 Omega493
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Statistical checks for the picks random_prng / random_trng make, to rerun whenever their engines
+// or index selection change for speed:
+//   selena_rng_quality [--engine prng|trng] [--scale x]
+// runs them and exits with 1 if any looks biased. Each check is a hypothesis test, so a correct
+// engine fails one once in a great while - rerun before suspecting anything, and suspect a check
+// which fails twice in a row. "--scale" multiplies the sample sizes (more power, more time).
+//   selena_rng_quality --stream [--engine prng|trng]
+// writes raw engine output to stdout until the reader goes away, for the external suites:
+//   selena_rng_quality --stream | RNG_test stdin64     (PractRand)
+//   selena_rng_quality --stream | <unif01 reading stdin> (TestU01)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "random.hpp"
+
+namespace {
+// Anything this unlikely under the null hypothesis counts as a failure
+constexpr double alpha{ 1e-5 };
+
+struct outcome {
+  size_t run{ 0 };
+  size_t failed{ 0 };
+};
+
+// Two-sided p-value of a standard normal z
+double normal_p(const double z) { return std::erfc(std::fabs(z) / std::sqrt(2.0)); }
+
+// Two-sided p-value of a chi-square statistic, through the Wilson-Hilferty normal approximation.
+// Too good a fit is as suspicious as too bad a one.
+double chi_square_p(const double chi2, const double df) {
+  const double v{ 2.0 / (9.0 * df) };
+  const double z{ (std::cbrt(chi2 / df) - (1.0 - v)) / std::sqrt(v) };
+  return normal_p(z);
+}
+
+void report(outcome& out, const std::string& name, const char* const stat_name, const double stat, const double p) {
+  const bool ok{ p >= alpha };
+  ++out.run;
+  if (!ok) ++out.failed;
+  std::printf("%-44s %6s = %14.4f   p = %.6f   %s\n", name.c_str(), stat_name, stat, p, ok ? "ok" : "FAIL");
+  std::fflush(stdout);
+}
+
+size_t scaled(const size_t n, const double scale) { return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(n) * scale)); }
+
+// random(vec) over a vector of 0..k-1, counting what comes back
+template<typename Rng>
+void chi_square_vector(outcome& out, const size_t k, const size_t draws) {
+  std::vector<uint32_t> vec(k);
+  std::iota(vec.begin(), vec.end(), 0u);
+  std::vector<uint64_t> counts(k);
+  for (size_t i{ 0 }; i < draws; ++i) ++counts[Rng::random(vec)];
+
+  const double expected{ static_cast<double>(draws) / static_cast<double>(k) };
+  double chi2{ 0 };
+  for (const uint64_t c : counts) chi2 += (static_cast<double>(c) - expected) * (static_cast<double>(c) - expected) / expected;
+  report(out, "chi-square random(vec), size " + std::to_string(k), "chi2", chi2, chi_square_p(chi2, static_cast<double>(k - 1)));
+}
+
+// Sizes no vector can have: the same draw through random_index(), binned into equal-width ranges.
+// 2^63 + 1 is the worst case for rejection sampling (almost half the raw values get rejected) and
+// for anything which only looks at 63 bits.
+template<typename Rng>
+void chi_square_index(outcome& out, const uint64_t n, const char* const label, const size_t draws) {
+  constexpr size_t bins{ 4096 };
+  const uint64_t width{ n / bins + (n % bins != 0) };
+  std::vector<uint64_t> counts(bins);
+  for (size_t i{ 0 }; i < draws; ++i) ++counts[Rng::random_index(n) / width];
+
+  double chi2{ 0 };
+  size_t used{ 0 };
+  for (size_t b{ 0 }; b < bins; ++b) {
+    const uint64_t lo{ b * width };
+    if (lo >= n) break;
+    const uint64_t len{ std::min(width, n - lo) };
+    const double expected{ static_cast<double>(draws) * (static_cast<double>(len) / static_cast<double>(n)) };
+    if (expected < 5) continue; // A (near) empty tail bin says nothing
+    chi2 += (static_cast<double>(counts[b]) - expected) * (static_cast<double>(counts[b]) - expected) / expected;
+    ++used;
+  }
+  report(out, std::string{ "chi-square random_index(" } + label + "), binned", "chi2", chi2,
+    chi_square_p(chi2, static_cast<double>(used - 1)));
+}
+
+// Lag-1 correlation between consecutive picks. Under independence, r * sqrt(n) is ~ N(0, 1).
+template<typename Rng>
+void serial_correlation(outcome& out, const uint64_t n, const char* const label, const size_t draws) {
+  double sum{ 0 }, sum_sq{ 0 }, sum_lag{ 0 };
+  double prev{ static_cast<double>(Rng::random_index(n)) };
+  for (size_t i{ 0 }; i < draws; ++i) {
+    const double x{ static_cast<double>(Rng::random_index(n)) };
+    sum += prev;
+    sum_sq += prev * prev;
+    sum_lag += prev * x;
+    prev = x;
+  }
+  const double d{ static_cast<double>(draws) };
+  const double mean{ sum / d };
+  const double var{ sum_sq / d - mean * mean };
+  const double r{ (sum_lag / d - mean * mean) / var };
+  report(out, std::string{ "serial correlation random_index(" } + label + ")", "r", r, normal_p(r * std::sqrt(d)));
+}
+
+// Marsaglia's birthday spacings: "m" birthdays in a year of "days" days, sorted; the number of
+// spacings which repeat an earlier one is ~ Poisson(m^3 / (4 * days)). Summed over "rounds" rounds,
+// it's Poisson(rounds * lambda), compared against its normal approximation.
+template<typename Rng>
+void birthday_spacings(outcome& out, const size_t m, const unsigned log2_days, const size_t rounds) {
+  const uint64_t days{ uint64_t{ 1 } << log2_days };
+  const double lambda{ std::pow(static_cast<double>(m), 3) / (4.0 * static_cast<double>(days)) };
+  std::vector<uint64_t> birthdays(m), spacings(m);
+  uint64_t repeats{ 0 };
+  for (size_t r{ 0 }; r < rounds; ++r) {
+    for (uint64_t& b : birthdays) b = Rng::random_index(days);
+    std::sort(birthdays.begin(), birthdays.end());
+    spacings[0] = birthdays[0];
+    for (size_t i{ 1 }; i < m; ++i) spacings[i] = birthdays[i] - birthdays[i - 1];
+    std::sort(spacings.begin(), spacings.end());
+    for (size_t i{ 1 }; i < m; ++i) repeats += spacings[i] == spacings[i - 1];
+  }
+  const double expected{ lambda * static_cast<double>(rounds) };
+  const double z{ (static_cast<double>(repeats) - expected) / std::sqrt(expected) };
+  report(out, "birthday spacings m=" + std::to_string(m) + " days=2^" + std::to_string(log2_days), "dups",
+    static_cast<double>(repeats), normal_p(z));
+}
+
+// shuffle() of 5 elements: each of the 120 orders equally likely. Orders are ranked by their
+// Lehmer code.
+template<typename Rng>
+void chi_square_shuffle(outcome& out, const size_t draws) {
+  constexpr size_t k{ 5 }, orders{ 120 };
+  std::vector<uint64_t> counts(orders);
+  std::vector<int> items(k);
+  for (size_t i{ 0 }; i < draws; ++i) {
+    std::iota(items.begin(), items.end(), 0);
+    Rng::shuffle(items);
+    size_t rank{ 0 };
+    for (size_t a{ 0 }; a < k; ++a) {
+      size_t smaller{ 0 };
+      for (size_t b{ a + 1 }; b < k; ++b) smaller += items[b] < items[a];
+      rank = rank * (k - a) + smaller;
+    }
+    ++counts[rank];
+  }
+
+  const double expected{ static_cast<double>(draws) / orders };
+  double chi2{ 0 };
+  for (const uint64_t c : counts) chi2 += (static_cast<double>(c) - expected) * (static_cast<double>(c) - expected) / expected;
+  report(out, "chi-square shuffle(), orders of 5", "chi2", chi2, chi_square_p(chi2, orders - 1));
+}
+
+// shuffle() of "k" elements, long enough for its batched draws: where the first element ends up
+template<typename Rng>
+void shuffle_position(outcome& out, const size_t k, const size_t draws) {
+  std::vector<uint64_t> counts(k);
+  std::vector<uint32_t> items(k);
+  for (size_t i{ 0 }; i < draws; ++i) {
+    std::iota(items.begin(), items.end(), 0u);
+    Rng::shuffle(items);
+    ++counts[static_cast<size_t>(std::find(items.begin(), items.end(), 0u) - items.begin())];
+  }
+
+  const double expected{ static_cast<double>(draws) / static_cast<double>(k) };
+  double chi2{ 0 };
+  for (const uint64_t c : counts) chi2 += (static_cast<double>(c) - expected) * (static_cast<double>(c) - expected) / expected;
+  report(out, "chi-square shuffle(), position of 0 of " + std::to_string(k), "chi2", chi2,
+    chi_square_p(chi2, static_cast<double>(k - 1)));
+}
+
+// weighted_sample() over weights 1..k: its first pick is a single weighted draw, index i with
+// probability (i + 1) / sum. "picks" small next to k goes through the exponential jumps, large
+// through the key per index.
+template<typename Rng>
+void weighted_first(outcome& out, const size_t k, const size_t picks, const size_t draws) {
+  std::vector<double> weights(k);
+  std::iota(weights.begin(), weights.end(), 1.0);
+  const double total{ static_cast<double>(k) * static_cast<double>(k + 1) / 2 };
+  std::vector<uint64_t> counts(k);
+  for (size_t i{ 0 }; i < draws; ++i) ++counts[Rng::weighted_sample(weights, picks).front()];
+
+  double chi2{ 0 };
+  for (size_t i{ 0 }; i < k; ++i) {
+    const double expected{ static_cast<double>(draws) * weights[i] / total };
+    chi2 += (static_cast<double>(counts[i]) - expected) * (static_cast<double>(counts[i]) - expected) / expected;
+  }
+  report(out, "chi-square weighted_sample(), first of " + std::to_string(picks), "chi2", chi2,
+    chi_square_p(chi2, static_cast<double>(k - 1)));
+}
+
+template<typename Rng>
+outcome run_checks(const double scale) {
+  outcome out{};
+  chi_square_vector<Rng>(out, 3, scaled(3'000'000, scale));
+  chi_square_vector<Rng>(out, 1'000'003, scaled(20'000'000, scale));
+  chi_square_index<Rng>(out, (uint64_t{ 1 } << 63) + 1, "2^63+1", scaled(4'000'000, scale));
+  chi_square_index<Rng>(out, UINT64_MAX, "2^64-1", scaled(4'000'000, scale));
+  serial_correlation<Rng>(out, 3, "3", scaled(4'000'000, scale));
+  serial_correlation<Rng>(out, uint64_t{ 1 } << 32, "2^32", scaled(4'000'000, scale));
+  birthday_spacings<Rng>(out, 512, 24, scaled(2'000, scale));
+  birthday_spacings<Rng>(out, 4096, 36, scaled(2'000, scale));
+  chi_square_shuffle<Rng>(out, scaled(1'200'000, scale));
+  shuffle_position<Rng>(out, 100, scaled(1'000'000, scale));
+  weighted_first<Rng>(out, 100, 2, scaled(1'000'000, scale));
+  weighted_first<Rng>(out, 100, 50, scaled(200'000, scale));
+  return out;
+}
+
+template<typename Rng>
+int stream() {
+  std::vector<unsigned char> buf(size_t{ 1 } << 16);
+  for (;;) {
+    Rng::random_bytes(buf.data(), buf.size());
+    if (std::fwrite(buf.data(), 1, buf.size(), stdout) != buf.size()) return 0; // Reader's done
+  }
+}
+
+void usage(const char* const argv0) {
+  std::fprintf(stderr, "Usage: %s [--engine prng|trng] [--scale x] [--stream]\n", argv0);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  bool trng{ false };
+  bool streaming{ false };
+  double scale{ 1.0 };
+  for (int i{ 1 }; i < argc; ++i) {
+    const char* const arg{ argv[i] };
+    const bool has_value{ i + 1 < argc };
+    if (!std::strcmp(arg, "--engine") && has_value) {
+      const char* const engine{ argv[++i] };
+      if (!std::strcmp(engine, "trng")) trng = true;
+      else if (std::strcmp(engine, "prng")) {
+        usage(argv[0]);
+        return 2;
+      }
+    } else if (!std::strcmp(arg, "--scale") && has_value) {
+      scale = std::strtod(argv[++i], nullptr);
+    } else if (!std::strcmp(arg, "--stream")) {
+      streaming = true;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (streaming) return trng ? stream<selena::random_trng>() : stream<selena::random_prng>();
+
+  std::printf("engine: %s, scale: %g, failure threshold: p < %g\n", trng ? "random_trng" : "random_prng", scale, alpha);
+  const outcome out{ trng ? run_checks<selena::random_trng>(scale) : run_checks<selena::random_prng>(scale) };
+  std::printf("%zu / %zu checks passed\n", out.run - out.failed, out.run);
+  return out.failed ? 1 : 0;
+}